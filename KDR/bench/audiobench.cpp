@@ -0,0 +1,88 @@
+/*
+ Times the audio mixer without a device
+ Not part of the engine, build it on its own from KDR/
+ with every .cpp in src/audio, like
+ g++ -O2 -std=c++14 -Isrc bench/audiobench.cpp src/audio/audio.cpp ... -lpthread
+ or cl /O2 /EHsc /Isrc bench\audiobench.cpp src\audio\audio.cpp ...
+ Add -mavx or /arch:AVX for the AVX kernels, or
+ -DKDR_NO_SIMD for the plain loops to compare against
+ */
+#include "audio/audio.hpp"
+#include "util/simd.hpp"
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+using namespace kdr;
+
+/*
+ How many blocks each run mixes
+ */
+#define BENCH_BLOCKS (2000)
+
+/*
+ The device's rate, sounds at 48000 skip resampling
+ */
+#define BENCH_RATE (48000)
+
+/*
+ Makes a second of a stereo sine at sample_rate
+ */
+static Sound makeSine(int sample_rate, double frequency) {
+	std::vector<int16_t> samples((size_t)sample_rate * 2);
+	for (int i = 0; i < sample_rate; ++i) {
+		const double phase = 2.0 * 3.14159265358979 * frequency * i / sample_rate;
+		samples[i * 2] = (int16_t)(12000.0 * sin(phase));
+		samples[i * 2 + 1] = (int16_t)(12000.0 * cos(phase));
+	}
+	return Sound(samples.data(), (uint32_t)sample_rate, 2, sample_rate);
+}
+
+/*
+ Mixes voices copies of sound for BENCH_BLOCKS blocks
+ and prints how many voices were mixed per ms of CPU
+ */
+static void run(const char* name, const Sound& sound, AudioResampler resampler, int voices) {
+	KDR_InitAudio(new NullAudioBackend(false), BENCH_RATE, false);
+	KDR_SetAudioResampler(resampler);
+	KDR_SetMasterVolume(1.0f / voices);
+	for (int i = 0; i < voices; ++i)
+		KDR_PlaySound(sound, 1.0f, (float)i / voices * 2.0f - 1.0f, true);
+
+	std::vector<float> block(AUDIO_BLOCK_FRAMES * 2);
+	// the first block applies the commands
+	KDR_MixAudio(block.data(), AUDIO_BLOCK_FRAMES);
+	const std::clock_t start = std::clock();
+	for (int i = 0; i < BENCH_BLOCKS; ++i)
+		KDR_MixAudio(block.data(), AUDIO_BLOCK_FRAMES);
+	const double cpu_ms = (double)(std::clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+	KDR_CloseAudio();
+
+	// a block of one voice counts as one voice mixed
+	const double audio_ms = (double)BENCH_BLOCKS * AUDIO_BLOCK_FRAMES * 1000.0 / BENCH_RATE;
+	const double safe_ms = cpu_ms > 0.0 ? cpu_ms : 1.0;
+	std::cout << name << "\t" << voices << " voices\t"
+		<< (double)voices * BENCH_BLOCKS / safe_ms << " voices/ms\t"
+		<< audio_ms / safe_ms << "x realtime" << std::endl;
+	return;
+}
+
+int main() {
+#if defined(KDR_AVX)
+	std::cout << "AVX kernels" << std::endl;
+#elif defined(KDR_SSE2)
+	std::cout << "SSE2 kernels" << std::endl;
+#else
+	std::cout << "plain kernels" << std::endl;
+#endif
+	const Sound same = makeSine(BENCH_RATE, 440.0);
+	const Sound other = makeSine(44100, 440.0);
+	const int voice_counts[] = { 1, 8, AUDIO_MAX_VOICES };
+	for (int voices : voice_counts) {
+		run("same rate", same, AudioResampler::Linear, voices);
+		run("linear", other, AudioResampler::Linear, voices);
+		run("cubic", other, AudioResampler::Cubic, voices);
+	}
+	return 0;
+}
\ No newline at end of file
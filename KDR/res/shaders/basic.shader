@@ -6,7 +6,11 @@ layout(location = 1) in vec2 uv;
 layout(location = 2) in float tid;
 layout(location = 3) in vec4 color;
 
-uniform mat4 pr_matrix;
+layout(std140) uniform kdr_frame {
+	mat4 kdr_projection;
+	mat4 kdr_view;
+	float kdr_time;
+};
 
 out DATA {
 	vec4 position;
@@ -16,7 +20,7 @@ out DATA {
 } vs_out;
 
 void main() { 
-	gl_Position = position * pr_matrix;
+	gl_Position = kdr_projection * kdr_view * position;
 	vs_out.position = position;
 	vs_out.uv = uv;
 	vs_out.tid = tid;
@@ -1,21 +1,31 @@
 #include "TestGame.hpp"
 #include <iostream>
 #include "gfx/shader.hpp"
+#include "gfx/uniformbuffer.hpp"
+#include "util/profiler.hpp"
+#include "input/input.hpp"
+#include "input/inputqueue.hpp"
+#include "input/inputrecorder.hpp"
+#include "input/actions.hpp"
 
 namespace kdr {
 	mat4* ortho;
 
 	TestGame::TestGame(const char* window_title, int width, int height, bool limit_framerate) {
-		loadAssets();
+		// the window calls loadAssets once it's made
 		window = new Window(*this, window_title, width, height, limit_framerate);
 		ortho = new mat4(mat4::ortho(0, width, height, 0, -100, 100));
 		renderer = new BatchRenderer(TileData(16, 5, 1));
+		renderer->setCullBounds(Rectangle(0, 0, width, height));
 		return;
 	}
 
 	Texture* texture;
 	Texture* texture2;
 	Shader* shader;
+	UniformBuffer* frame_buffer;
+	FrameData frame;
+	uint64_t export_profile, toggle_recording, show_profiler, screenshot;
 
 	void TestGame::loadAssets() {
 		texture = new Texture("res/textures/tb.png");
@@ -25,39 +35,82 @@ namespace kdr {
 
 	int TestGame::run() {
 		init();
-		while (window->isRunning()) {
-			update();
-			draw();
-		}
-
-		return EXIT_SUCCESS;
+		// the loop presents outside of draw's zone so
+		// the profiler sees each frame's full time
+		const int result = loop.run(*this);
+		clean();
+		return result;
 	}
 
 	void TestGame::init() {
-		shader = new Shader();
+		shader = new Shader("res/shaders/basic.shader", true, "#shader", "vertex", "fragment");
+		// edits to the file show up without restarting
+		shader->watch();
 		GLint texIDs[] = {
 			0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31
 		};
 		shader->bind();
 		shader->setUniform1iv("textures", texIDs, 32);
-		shader->setUniformMat4("pr_matrix", *ortho);
 		shader->unbind();
 
+		// every shader with the kdr_frame block reads
+		// the projection, view and time from here
+		frame_buffer = new UniformBuffer(KDR_FRAME_BINDING, sizeof(FrameData));
+		frame.projection = *ortho;
+		frame.view = mat4::identity();
+		frame.time = 0.0f;
+
 		KDR_AddFont(new Font("SourceSansPro", "res/fonts/SourceSansPro-Light.TTF", 12));
 
+		KDR_LoadActions("res/actions.json");
+		export_profile = KDR_ActionMask("export_profile");
+		toggle_recording = KDR_ActionMask("toggle_recording");
+		show_profiler = KDR_ActionMask("show_profiler");
+		screenshot = KDR_ActionMask("screenshot");
+
 		return;
 	}
 
 	void TestGame::update() {
-		BatchRenderer batch = BatchRenderer(TileData(0, 0, 0));
-		window->clear();
+		KDR_PROFILE_ZONE("Game::update");
 		window->update();
+		// picks up shader edits if the shader is watched
+		shader->reload();
+
+		// the queue has every input in order, drain it each
+		// tick so it never fills up and drops events
+		InputEvent event;
+		while (KDR_PollInputEvent(event))
+			// redraw on input when the loop is idle
+			loop.markDirty();
+
+		// F4 dumps the profiler's history for chrome://tracing
+		if (KDR_ActionTriggered(export_profile))
+			KDR_ExportProfilerTrace("profile.json");
+
+		// F5 starts and stops recording input for replays
+		static bool recording = false;
+		if (KDR_ActionTriggered(toggle_recording)) {
+			if (recording)
+				KDR_StopRecording();
+			else
+				KDR_StartRecording("session.kdrinput");
+			recording = !recording;
+		}
+
+		// F12 saves the next frame without stalling
+		if (KDR_ActionTriggered(screenshot))
+			window->captureFrame("screenshot.png");
 		return;
 	}
 
 	void TestGame::draw() {
+		KDR_PROFILE_ZONE("Game::draw");
+		window->clear();
 		Font* font = KDR_GetFont("SourceSansPro");
 		srand(NULL);
+		frame.time = (float)KDR_LoopTime();
+		frame_buffer->setData(&frame, sizeof(FrameData));
 		shader->bind();
 		renderer->begin();
 		
@@ -85,26 +138,36 @@ namespace kdr {
 		renderer->drawString("Test", *font, vec3(500, 500, 0), vec4(1, 1, 1, 1).toColor1());
 		renderer->draw(texture, Rectangle(600, 600, 200, 200), vec4(1, 1, 1, 1).toColor1());
 
+		// hold F3 to see the last frame's timings
+		if (KDR_ActionDown(show_profiler))
+			KDR_DrawProfiler(*renderer, *font, vec3(10, window->getHeight() - 20, 0), vec4(1, 1, 0, 1).toColor1());
+
 		renderer->end();
 		renderer->flush();
 
 		shader->unbind();
-
-		window->draw();
 		return;
 	}
 
 	void TestGame::windowResize() {
 		delete ortho;
 		ortho = new mat4(mat4::ortho(0, window->getWidth(), window->getHeight(), 0, -100, 100));
-		shader->bind();
-		shader->setUniformMat4("pr_matrix", *ortho);
-		shader->unbind();
+		renderer->setCullBounds(Rectangle(0, 0, window->getWidth(), window->getHeight()));
+		// uploaded with the rest of the frame in draw
+		frame.projection = *ortho;
 		std::cout << "Resized" << std::endl;
 		return;
 	}
 
 	void TestGame::clean() {
+		// finishes the recording if the window
+		// was closed while recording
+		KDR_StopRecording();
+		delete renderer;
+		delete frame_buffer;
+		delete shader;
+		KDR_CleanRendererData();
+		KDR_CleanProfiler();
 		delete window;
 		return;
 	}
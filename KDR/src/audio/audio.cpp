@@ -0,0 +1,654 @@
+#include "audio.hpp"
+#include "audioqueue.hpp"
+#include "mixkernels.hpp"
+#include "wavdecoder.hpp"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <string.h>
+
+namespace kdr {
+	static_assert((AUDIO_STREAM_FRAMES & (AUDIO_STREAM_FRAMES - 1)) == 0, "AUDIO_STREAM_FRAMES has to be a power of 2");
+
+	/*
+	 A file being read ahead of the mixer
+	 The streaming thread writes frames, the mixer reads them
+	 */
+	struct AudioStream {
+		WavDecoder decoder;
+		/*
+		 A ring of frames, channels interleaved
+		 */
+		int16_t samples[AUDIO_STREAM_FRAMES * 2];
+		/*
+		 The first frame the mixer still needs, only written by the mixer
+		 */
+		std::atomic<uint64_t> head;
+		/*
+		 One past the last frame read, only written by the streaming thread
+		 */
+		std::atomic<uint64_t> tail;
+		/*
+		 Set once the file has no more frames
+		 */
+		std::atomic<bool> finished;
+		bool loop;
+
+		AudioStream() : head(0), tail(0), finished(false), loop(false) {}
+	};
+
+	enum class AudioCommandType {
+		Play,
+		Stop,
+		Volume,
+		Pan,
+		Master,
+		Resampler
+	};
+
+	/*
+	 Something for the mixer to do
+	 */
+	struct AudioCommand {
+		AudioCommandType type;
+		unsigned int voice;
+		const Sound* sound;
+		AudioStream* stream;
+		float volume, pan;
+		bool loop;
+		AudioResampler resampler;
+	};
+
+	/*
+	 A sound being played, only touched by the mixer
+	 */
+	struct Voice {
+		/*
+		 The handle the game knows it by, 0 when free
+		 */
+		unsigned int handle;
+		const int16_t* samples;
+		uint32_t frames;
+		AudioStream* stream;
+		int channels;
+		/*
+		 The frame being played in 32.32 fixed point,
+		 for streams it's counted from the stream's head
+		 which stays a frame behind for the cubic curve
+		 */
+		uint64_t position;
+		/*
+		 How far position moves each output frame
+		 */
+		uint64_t step;
+		float volume, pan;
+		float gain_left, gain_right;
+		bool loop;
+		/*
+		 Done playing but the game hasn't been told yet
+		 */
+		bool finished;
+	};
+
+	/*
+	 What the game knows about a voice
+	 */
+	struct VoiceSlot {
+		bool used;
+		unsigned int generation;
+		AudioStream* stream;
+	};
+
+	// the game's side
+	VoiceSlot voice_slots[AUDIO_MAX_VOICES];
+	AudioQueue<AudioCommand, AUDIO_QUEUE_SIZE> audio_commands;
+	AudioQueue<unsigned int, AUDIO_QUEUE_SIZE> finished_voices;
+	AudioBackend* audio_backend = nullptr;
+	int device_rate = 0;
+	bool audio_threaded = true;
+
+	// the mixer's side
+	Voice voices[AUDIO_MAX_VOICES];
+	float master_volume = 1.0f;
+	AudioResampler resampler = AudioResampler::Linear;
+	std::vector<float> mix_block;
+	/*
+	 A voice's frames for this block as floats
+	 */
+	std::vector<float> source_block;
+	std::atomic<unsigned int> underruns(0);
+
+	// the threads and the streams they share
+	std::atomic<bool> audio_running(false);
+	std::thread mixer_thread;
+	std::thread streaming_thread;
+	std::mutex streams_mutex;
+	std::vector<AudioStream*> streams;
+
+	static inline int voiceSlot(unsigned int voice) {
+		return (int)(voice & 0xFF) - 1;
+	}
+
+	/*
+	 Reads frames from disk until the stream's ring is nearly full
+	 Called with streams_mutex held, or before the stream is shared
+	 */
+	static void fillStream(AudioStream& stream) {
+		const int channels = stream.decoder.getChannels();
+		uint64_t tail = stream.tail.load(std::memory_order_relaxed);
+		while (!stream.finished.load(std::memory_order_relaxed)) {
+			const uint64_t space = AUDIO_STREAM_FRAMES - (tail - stream.head.load(std::memory_order_acquire));
+			if (space == 0)
+				break;
+			// the ring's end is as far as one read can go
+			const unsigned int offset = (unsigned int)(tail & (AUDIO_STREAM_FRAMES - 1));
+			int count = (int)std::min<uint64_t>(space, AUDIO_STREAM_CHUNK);
+			count = std::min(count, (int)(AUDIO_STREAM_FRAMES - offset));
+			const int read = stream.decoder.read(&stream.samples[offset * channels], count);
+			if (read == 0) {
+				// looping carries straight on from the first frame
+				if (stream.loop && stream.decoder.getFrames() > 0 && stream.decoder.rewind())
+					continue;
+				stream.finished.store(true, std::memory_order_release);
+				break;
+			}
+			tail += read;
+			// release so the mixer sees the frames before the new tail
+			stream.tail.store(tail, std::memory_order_release);
+		}
+		return;
+	}
+
+	static void fillStreams() {
+		std::lock_guard<std::mutex> lock(streams_mutex);
+		for (AudioStream* stream : streams)
+			fillStream(*stream);
+		return;
+	}
+
+	/*
+	 Works out each speaker's gain from volume and pan
+	 The middle plays at full volume in both speakers
+	 */
+	static void updateGains(Voice& voice) {
+		const float pan = std::min(std::max(voice.pan, -1.0f), 1.0f);
+		voice.gain_left = voice.volume * std::min(1.0f, 1.0f - pan);
+		voice.gain_right = voice.volume * std::min(1.0f, 1.0f + pan);
+		return;
+	}
+
+	static void applyCommands() {
+		AudioCommand command;
+		while (audio_commands.pop(command)) {
+			if (command.type == AudioCommandType::Master) {
+				master_volume = command.volume;
+				continue;
+			}
+			if (command.type == AudioCommandType::Resampler) {
+				resampler = command.resampler;
+				continue;
+			}
+
+			Voice& voice = voices[voiceSlot(command.voice)];
+			if (command.type == AudioCommandType::Play) {
+				memset(&voice, 0, sizeof(voice));
+				voice.handle = command.voice;
+				int sample_rate;
+				if (command.stream != nullptr) {
+					voice.stream = command.stream;
+					voice.channels = command.stream->decoder.getChannels();
+					sample_rate = command.stream->decoder.getSampleRate();
+				}
+				else {
+					voice.samples = command.sound->getSamples();
+					voice.frames = command.sound->getFrames();
+					voice.channels = command.sound->getChannels();
+					sample_rate = command.sound->getSampleRate();
+				}
+				voice.step = ((uint64_t)sample_rate << 32) / device_rate;
+				voice.volume = command.volume;
+				voice.pan = command.pan;
+				voice.loop = command.loop;
+				updateGains(voice);
+				continue;
+			}
+
+			// the voice may have finished and been reused
+			if (voice.handle != command.voice)
+				continue;
+			switch (command.type) {
+			case AudioCommandType::Stop:
+				voice.finished = true;
+				break;
+			case AudioCommandType::Volume:
+				voice.volume = command.volume;
+				updateGains(voice);
+				break;
+			case AudioCommandType::Pan:
+				voice.pan = command.pan;
+				updateGains(voice);
+				break;
+			default:
+				break;
+			}
+		}
+		return;
+	}
+
+	/*
+	 Converts a sound's frames from first into out
+	 Looping sounds wrap around, anything else past the ends is silent
+	 */
+	static void fetchSound(const Voice& voice, int64_t first, int count, float* out) {
+		const int channels = voice.channels;
+		const int64_t frames = voice.frames;
+		int done = 0;
+		while (done < count) {
+			int64_t index = first + done;
+			if (voice.loop) {
+				index %= frames;
+				if (index < 0)
+					index += frames;
+			}
+			int run;
+			if (index < 0 || index >= frames) {
+				run = index < 0 ? (int)std::min<int64_t>(count - done, -index) : count - done;
+				memset(out + done * channels, 0, sizeof(float) * run * channels);
+			}
+			else {
+				run = (int)std::min<int64_t>(count - done, frames - index);
+				KDR_ConvertSamples(voice.samples + index * channels, out + done * channels, run * channels);
+			}
+			done += run;
+		}
+		return;
+	}
+
+	/*
+	 Converts a stream's frames from first, counted from head, into out
+	 Frames the streaming thread hasn't read yet are silent
+	 */
+	static void fetchStream(const Voice& voice, uint64_t head, uint64_t available, int64_t first, int count, float* out) {
+		const AudioStream& stream = *voice.stream;
+		const int channels = voice.channels;
+		int done = 0;
+		while (done < count) {
+			const int64_t index = first + done;
+			int run;
+			if (index < 0 || index >= (int64_t)available) {
+				run = index < 0 ? (int)std::min<int64_t>(count - done, -index) : count - done;
+				memset(out + done * channels, 0, sizeof(float) * run * channels);
+			}
+			else {
+				// the ring's end is as far as one run can go
+				const unsigned int offset = (unsigned int)((head + index) & (AUDIO_STREAM_FRAMES - 1));
+				run = (int)std::min<int64_t>(count - done, (int64_t)available - index);
+				run = std::min(run, (int)(AUDIO_STREAM_FRAMES - offset));
+				KDR_ConvertSamples(stream.samples + offset * channels, out + done * channels, run * channels);
+			}
+			done += run;
+		}
+		return;
+	}
+
+	/*
+	 Adds a voice's frames to out
+	 Returns false once it has nothing left to play
+	 */
+	static bool mixVoice(Voice& voice, float* out, int frames) {
+		const int channels = voice.channels;
+		int count = frames;
+		uint64_t head = 0, available = 0;
+		bool done = false;
+		if (voice.stream != nullptr) {
+			AudioStream& stream = *voice.stream;
+			// finished before tail, so the tail can't grow
+			// after we've decided the stream is over
+			done = stream.finished.load(std::memory_order_acquire);
+			head = stream.head.load(std::memory_order_relaxed);
+			available = stream.tail.load(std::memory_order_acquire) - head;
+			if (done && (voice.position >> 32) >= available)
+				return false;
+			if (!done) {
+				// only play frames whose neighbours have all arrived,
+				// the rest of the block is silent until the
+				// streaming thread catches up
+				const uint64_t end = available > 2 ? (available - 2) << 32 : 0;
+				const uint64_t ready = end > voice.position ? (end - voice.position + voice.step - 1) / voice.step : 0;
+				if (ready < (uint64_t)frames) {
+					count = (int)ready;
+					underruns.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+		}
+		else if (!voice.loop && (voice.position >> 32) >= voice.frames)
+			return false;
+
+		if (count > 0) {
+			// one frame before the first and two after the last
+			// are enough for either resampler
+			const int64_t first = (int64_t)(voice.position >> 32);
+			const int64_t last = (int64_t)((voice.position + (uint64_t)(count - 1) * voice.step) >> 32);
+			const int fetched = (int)(last - first) + 4;
+			if (source_block.size() < (size_t)fetched * channels)
+				source_block.resize((size_t)fetched * channels);
+			if (voice.stream != nullptr)
+				fetchStream(voice, head, available, first - 1, fetched, source_block.data());
+			else
+				fetchSound(voice, first - 1, fetched, source_block.data());
+
+			// the kernels only need where we are within the first frame
+			const float* source = source_block.data() + channels;
+			const uint64_t position = (uint32_t)voice.position;
+			if (voice.step == (uint64_t)1 << 32 && position == 0)
+				KDR_MixSamples(source, channels, voice.gain_left, voice.gain_right, out, count);
+			else if (resampler == AudioResampler::Cubic)
+				KDR_MixCubic(source, channels, position, voice.step, voice.gain_left, voice.gain_right, out, count);
+			else
+				KDR_MixLinear(source, channels, position, voice.step, voice.gain_left, voice.gain_right, out, count);
+			voice.position += (uint64_t)count * voice.step;
+		}
+
+		if (voice.stream != nullptr) {
+			// hand the frames behind us back to the streaming
+			// thread, except the one the cubic curve looks back at
+			// a block can run past the end of the file, but the
+			// head can never pass the tail
+			const uint64_t played = voice.position >> 32;
+			const uint64_t consumed = std::min(played, available);
+			if (consumed > 1) {
+				voice.position -= (consumed - 1) << 32;
+				voice.stream->head.store(head + consumed - 1, std::memory_order_release);
+			}
+			if (done && played >= available)
+				return false;
+		}
+		else if (voice.loop)
+			voice.position %= (uint64_t)voice.frames << 32;
+		return true;
+	}
+
+	/*
+	 Makes the next frames of audio
+	 Only called from the mixer
+	 */
+	static void mix(float* out, int frames) {
+		applyCommands();
+		memset(out, 0, sizeof(float) * frames * 2);
+
+		for (Voice& voice : voices) {
+			if (voice.handle == 0)
+				continue;
+			if (!voice.finished) {
+				voice.finished = !mixVoice(voice, out, frames);
+			}
+			// if the game hasn't emptied the queue
+			// we try telling it again next block
+			if (voice.finished && finished_voices.push(voice.handle))
+				voice.handle = 0;
+		}
+
+		KDR_ClipSamples(out, frames * 2, master_volume);
+		return;
+	}
+
+	static void mixerLoop() {
+		while (audio_running.load(std::memory_order_acquire)) {
+			mix(mix_block.data(), AUDIO_BLOCK_FRAMES);
+			// the backend waits for the device, which
+			// keeps this loop in time
+			audio_backend->write(mix_block.data(), AUDIO_BLOCK_FRAMES);
+		}
+		return;
+	}
+
+	static void streamingLoop() {
+		while (audio_running.load(std::memory_order_acquire)) {
+			fillStreams();
+			std::this_thread::sleep_for(std::chrono::milliseconds(AUDIO_STREAM_INTERVAL));
+		}
+		return;
+	}
+
+	/*
+	 Frees the voices the mixer finished with
+	 */
+	static void collectVoices() {
+		unsigned int voice;
+		while (finished_voices.pop(voice)) {
+			VoiceSlot& slot = voice_slots[voiceSlot(voice)];
+			if (slot.stream != nullptr) {
+				{
+					std::lock_guard<std::mutex> lock(streams_mutex);
+					streams.erase(std::find(streams.begin(), streams.end(), slot.stream));
+				}
+				delete slot.stream;
+				slot.stream = nullptr;
+			}
+			slot.used = false;
+		}
+		return;
+	}
+
+	/*
+	 Finds a free voice and gives it a new handle
+	 Returns 0 if they're all busy
+	 */
+	static unsigned int claimVoice() {
+		for (int i = 0; i < AUDIO_MAX_VOICES; ++i) {
+			VoiceSlot& slot = voice_slots[i];
+			if (slot.used)
+				continue;
+			// a new generation keeps old handles
+			// from touching the new sound
+			slot.generation = (slot.generation + 1) & 0xFFFFFF;
+			if (slot.generation == 0)
+				slot.generation = 1;
+			return slot.generation << 8 | (unsigned int)(i + 1);
+		}
+		return 0;
+	}
+
+	/*
+	 Sends a command to a voice the game still has
+	 */
+	static void sendCommand(AudioCommandType type, unsigned int voice, float volume, float pan) {
+		if (!KDR_VoicePlaying(voice))
+			return;
+		AudioCommand command;
+		memset(&command, 0, sizeof(command));
+		command.type = type;
+		command.voice = voice;
+		command.volume = volume;
+		command.pan = pan;
+		audio_commands.push(command);
+		return;
+	}
+
+	bool KDR_InitAudio(AudioBackend* backend, int sample_rate, bool threaded) {
+		KDR_CloseAudio();
+		if (!backend->open(sample_rate)) {
+			delete backend;
+			return false;
+		}
+		audio_backend = backend;
+		device_rate = sample_rate;
+		audio_threaded = threaded;
+		master_volume = 1.0f;
+		resampler = AudioResampler::Linear;
+		mix_block.resize(AUDIO_BLOCK_FRAMES * 2);
+		// enough for a block at the same rate, faster
+		// sounds make it grow on the mixer
+		source_block.resize((AUDIO_BLOCK_FRAMES + 4) * 2);
+
+		if (threaded) {
+			audio_running.store(true, std::memory_order_release);
+			mixer_thread = std::thread(mixerLoop);
+			streaming_thread = std::thread(streamingLoop);
+		}
+		return true;
+	}
+
+	void KDR_CloseAudio() {
+		if (audio_backend == nullptr)
+			return;
+		audio_running.store(false, std::memory_order_release);
+		if (mixer_thread.joinable())
+			mixer_thread.join();
+		if (streaming_thread.joinable())
+			streaming_thread.join();
+
+		audio_backend->close();
+		delete audio_backend;
+		audio_backend = nullptr;
+
+		// nobody else is left to read the queues
+		AudioCommand command;
+		while (audio_commands.pop(command));
+		unsigned int voice;
+		while (finished_voices.pop(voice));
+		for (AudioStream* stream : streams)
+			delete stream;
+		streams.clear();
+		for (VoiceSlot& slot : voice_slots) {
+			slot.used = false;
+			slot.stream = nullptr;
+		}
+		memset(voices, 0, sizeof(voices));
+		return;
+	}
+
+	void KDR_UpdateAudio() {
+		collectVoices();
+		return;
+	}
+
+	void KDR_MixAudio(float* samples, int frames) {
+		if (audio_backend == nullptr || audio_threaded)
+			return;
+		// without the streaming thread the
+		// streams are read right before mixing
+		fillStreams();
+		mix(samples, frames);
+		audio_backend->write(samples, frames);
+		return;
+	}
+
+	unsigned int KDR_PlaySound(const Sound& sound, float volume, float pan, bool loop) {
+		if (audio_backend == nullptr || !sound.isLoaded())
+			return 0;
+		collectVoices();
+		const unsigned int voice = claimVoice();
+		if (voice == 0)
+			return 0;
+
+		AudioCommand command;
+		memset(&command, 0, sizeof(command));
+		command.type = AudioCommandType::Play;
+		command.voice = voice;
+		command.sound = &sound;
+		command.volume = volume;
+		command.pan = pan;
+		command.loop = loop;
+		if (!audio_commands.push(command))
+			return 0;
+		voice_slots[voiceSlot(voice)].used = true;
+		return voice;
+	}
+
+	unsigned int KDR_PlayStream(const char* file_path, float volume, float pan, bool loop) {
+		if (audio_backend == nullptr)
+			return 0;
+		collectVoices();
+		const unsigned int voice = claimVoice();
+		if (voice == 0)
+			return 0;
+
+		AudioStream* stream = new AudioStream();
+		if (!stream->decoder.open(file_path)) {
+			delete stream;
+			return 0;
+		}
+		stream->loop = loop;
+		// nobody else has it yet, so fill it here and
+		// the mixer can start playing straight away
+		fillStream(*stream);
+		{
+			std::lock_guard<std::mutex> lock(streams_mutex);
+			streams.push_back(stream);
+		}
+
+		AudioCommand command;
+		memset(&command, 0, sizeof(command));
+		command.type = AudioCommandType::Play;
+		command.voice = voice;
+		command.stream = stream;
+		command.volume = volume;
+		command.pan = pan;
+		if (!audio_commands.push(command)) {
+			{
+				std::lock_guard<std::mutex> lock(streams_mutex);
+				streams.pop_back();
+			}
+			delete stream;
+			return 0;
+		}
+		VoiceSlot& slot = voice_slots[voiceSlot(voice)];
+		slot.used = true;
+		slot.stream = stream;
+		return voice;
+	}
+
+	void KDR_StopVoice(unsigned int voice) {
+		sendCommand(AudioCommandType::Stop, voice, 0.0f, 0.0f);
+		return;
+	}
+
+	void KDR_SetVoiceVolume(unsigned int voice, float volume) {
+		sendCommand(AudioCommandType::Volume, voice, volume, 0.0f);
+		return;
+	}
+
+	void KDR_SetVoicePan(unsigned int voice, float pan) {
+		sendCommand(AudioCommandType::Pan, voice, 0.0f, pan);
+		return;
+	}
+
+	void KDR_SetMasterVolume(float volume) {
+		if (audio_backend == nullptr)
+			return;
+		AudioCommand command;
+		memset(&command, 0, sizeof(command));
+		command.type = AudioCommandType::Master;
+		command.volume = volume;
+		audio_commands.push(command);
+		return;
+	}
+
+	void KDR_SetAudioResampler(AudioResampler type) {
+		if (audio_backend == nullptr)
+			return;
+		AudioCommand command;
+		memset(&command, 0, sizeof(command));
+		command.type = AudioCommandType::Resampler;
+		command.resampler = type;
+		audio_commands.push(command);
+		return;
+	}
+
+	bool KDR_VoicePlaying(unsigned int voice) {
+		const int index = voiceSlot(voice);
+		if (index < 0 || index >= AUDIO_MAX_VOICES)
+			return false;
+		collectVoices();
+		const VoiceSlot& slot = voice_slots[index];
+		return slot.used && slot.generation == voice >> 8;
+	}
+
+	unsigned int KDR_AudioUnderruns() {
+		return underruns.load(std::memory_order_relaxed);
+	}
+}
\ No newline at end of file
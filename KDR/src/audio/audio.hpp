@@ -0,0 +1,141 @@
+#ifndef _KDR_AUDIO_HPP
+#define _KDR_AUDIO_HPP
+
+#include "audiobackend.hpp"
+#include "sound.hpp"
+
+/*
+ How many sounds can play at once
+ Playing more returns 0 until one finishes
+ */
+#define AUDIO_MAX_VOICES (32)
+
+/*
+ How many frames the mixer makes at once
+ Smaller has less latency but wakes up more
+ */
+#define AUDIO_BLOCK_FRAMES (512)
+
+/*
+ How many commands can wait for the mixer,
+ has to be a power of 2
+ */
+#define AUDIO_QUEUE_SIZE (256)
+
+/*
+ How many frames of a stream are read ahead
+ of the mixer, has to be a power of 2
+ */
+#define AUDIO_STREAM_FRAMES (16384)
+
+/*
+ The most frames a stream reads from disk at once
+ */
+#define AUDIO_STREAM_CHUNK (4096)
+
+/*
+ How often streams are topped up, in milliseconds
+ */
+#define AUDIO_STREAM_INTERVAL (5)
+
+namespace kdr {
+	/*
+	 How sounds at another rate than the device are played
+	 Linear is cheaper, Cubic keeps more of the highs
+	 */
+	enum class AudioResampler {
+		Linear,
+		Cubic
+	};
+
+	/*
+	 Starts the mixer
+	 The mixer runs on its own thread and only talks to the
+	 game through lock-free queues, streams are read from disk
+	 on a second thread so the mixer never waits on a file
+	 Every other audio function has to be called from the
+	 thread that called this one
+	 @param backend: where the audio goes, KDR deletes it
+	 when audio is closed
+	 @param sample_rate: the device's frames a second, sounds
+	 at other rates are resampled
+	 @param threaded: false mixes only when KDR_MixAudio is called,
+	 so tests get the same samples every run
+	 Returns false if the backend couldn't be opened
+	 */
+	bool KDR_InitAudio(AudioBackend* backend, int sample_rate = 48000, bool threaded = true);
+
+	/*
+	 Stops every voice and the mixer
+	 and deletes the backend
+	 */
+	void KDR_CloseAudio();
+
+	/*
+	 Frees the voices that finished playing
+	 Call once a tick
+	 */
+	void KDR_UpdateAudio();
+
+	/*
+	 Mixes frames of stereo audio into samples and sends them to the backend
+	 Only works when audio was started with threaded set to false
+	 */
+	void KDR_MixAudio(float* samples, int frames);
+
+	/*
+	 Plays a sound that's in memory
+	 The sound has to outlive the voice
+	 @param volume: 1 is the sound's own volume
+	 @param pan: -1 is only the left speaker, 1 only the right
+	 @param loop: play until stopped
+	 Returns the voice playing it, or 0 if every voice is busy
+	 */
+	unsigned int KDR_PlaySound(const Sound& sound, float volume = 1.0f, float pan = 0.0f, bool loop = false);
+
+	/*
+	 Plays a WAV file while reading it from disk a chunk at a time
+	 For music and anything else too long to keep in memory
+	 Returns the voice playing it, or 0 if every voice is
+	 busy or the file can't be played
+	 */
+	unsigned int KDR_PlayStream(const char* file_path, float volume = 1.0f, float pan = 0.0f, bool loop = false);
+
+	/*
+	 Stops a voice, does nothing if it already finished
+	 */
+	void KDR_StopVoice(unsigned int voice);
+
+	/*
+	 Changes how loud a voice is
+	 */
+	void KDR_SetVoiceVolume(unsigned int voice, float volume);
+
+	/*
+	 Changes which speaker a voice plays from
+	 */
+	void KDR_SetVoicePan(unsigned int voice, float pan);
+
+	/*
+	 Changes how loud everything is
+	 */
+	void KDR_SetMasterVolume(float volume);
+
+	/*
+	 Changes how every voice is resampled, Linear to start with
+	 */
+	void KDR_SetAudioResampler(AudioResampler type);
+
+	/*
+	 Returns true until a voice finishes or is stopped
+	 */
+	bool KDR_VoicePlaying(unsigned int voice);
+
+	/*
+	 Returns how many times a stream couldn't be read
+	 fast enough and the mixer played silence
+	 */
+	unsigned int KDR_AudioUnderruns();
+}
+
+#endif // hi :)
\ No newline at end of file
@@ -0,0 +1,203 @@
+#include "audiobackend.hpp"
+#include <iostream>
+#include <thread>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <mmsystem.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "winmm.lib")
+#endif
+#endif
+
+namespace kdr {
+	/*
+	 Converts float samples to 16 bit
+	 */
+	static void convertSamples(short* out, const float* samples, int count) {
+		for (int i = 0; i < count; ++i) {
+			const float value = samples[i] < -1.0f ? -1.0f : samples[i] > 1.0f ? 1.0f : samples[i];
+			out[i] = (short)(value * 32767.0f);
+		}
+		return;
+	}
+
+	NullAudioBackend::NullAudioBackend(bool realtime)
+	: realtime(realtime), sample_rate(0) {
+		return;
+	}
+
+	bool NullAudioBackend::open(int sample_rate) {
+		this->sample_rate = sample_rate;
+		deadline = std::chrono::steady_clock::now();
+		return true;
+	}
+
+	void NullAudioBackend::write(const float* /*samples*/, int frames) {
+		if (!realtime)
+			return;
+		// waiting for a deadline instead of sleeping for each
+		// block keeps sleep's inaccuracy from adding up
+		deadline += std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>((double)frames / sample_rate));
+		std::this_thread::sleep_until(deadline);
+		return;
+	}
+
+	void NullAudioBackend::close() {
+		return;
+	}
+
+	FileAudioBackend::FileAudioBackend(const char* file_path, bool realtime)
+	: NullAudioBackend(realtime), file_path(file_path), frames(0) {
+		return;
+	}
+
+	void FileAudioBackend::writeHeader() {
+		const uint32_t data_size = frames * 4;
+		unsigned char header[44];
+		memcpy(header, "RIFF", 4);
+		const uint32_t riff_size = 36 + data_size;
+		memcpy(header + 4, &riff_size, 4);
+		memcpy(header + 8, "WAVEfmt ", 8);
+		const uint32_t format_size = 16;
+		const uint16_t format = 1, channels = 2, block_align = 4, bits = 16;
+		const uint32_t rate = (uint32_t)sample_rate, byte_rate = rate * 4;
+		memcpy(header + 16, &format_size, 4);
+		memcpy(header + 20, &format, 2);
+		memcpy(header + 22, &channels, 2);
+		memcpy(header + 24, &rate, 4);
+		memcpy(header + 28, &byte_rate, 4);
+		memcpy(header + 32, &block_align, 2);
+		memcpy(header + 34, &bits, 2);
+		memcpy(header + 36, "data", 4);
+		memcpy(header + 40, &data_size, 4);
+		stream.seekp(0);
+		stream.write((const char*)header, sizeof(header));
+		return;
+	}
+
+	bool FileAudioBackend::open(int sample_rate) {
+		NullAudioBackend::open(sample_rate);
+		stream.open(file_path, std::ios::binary | std::ios::trunc);
+		if (!stream) {
+			std::cout << "Unable to write audio to: " << file_path << std::endl;
+			return false;
+		}
+		frames = 0;
+		// the sizes are filled in on close
+		writeHeader();
+		return true;
+	}
+
+	void FileAudioBackend::write(const float* samples, int frames) {
+		converted.resize(frames * 2);
+		convertSamples(converted.data(), samples, frames * 2);
+		stream.write((const char*)converted.data(), converted.size() * sizeof(short));
+		this->frames += frames;
+		NullAudioBackend::write(samples, frames);
+		return;
+	}
+
+	void FileAudioBackend::close() {
+		if (!stream.is_open())
+			return;
+		writeHeader();
+		stream.close();
+		return;
+	}
+
+#ifdef _WIN32
+	WaveOutAudioBackend::WaveOutAudioBackend()
+	: device(nullptr), event(nullptr), headers(new WAVEHDR[AUDIO_DEVICE_BUFFERS]), next(0) {
+		memset(headers, 0, sizeof(WAVEHDR) * AUDIO_DEVICE_BUFFERS);
+		return;
+	}
+
+	WaveOutAudioBackend::~WaveOutAudioBackend() {
+		close();
+		delete[] (WAVEHDR*)headers;
+		return;
+	}
+
+	bool WaveOutAudioBackend::open(int sample_rate) {
+		WAVEFORMATEX format;
+		memset(&format, 0, sizeof(format));
+		format.wFormatTag = WAVE_FORMAT_PCM;
+		format.nChannels = 2;
+		format.nSamplesPerSec = sample_rate;
+		format.wBitsPerSample = 16;
+		format.nBlockAlign = 4;
+		format.nAvgBytesPerSec = sample_rate * 4;
+
+		event = CreateEvent(NULL, FALSE, FALSE, NULL);
+		HWAVEOUT handle;
+		if (waveOutOpen(&handle, WAVE_MAPPER, &format, (DWORD_PTR)event, 0, CALLBACK_EVENT) != MMSYSERR_NOERROR) {
+			std::cout << "Unable to open the audio device" << std::endl;
+			CloseHandle((HANDLE)event);
+			event = nullptr;
+			return false;
+		}
+		device = handle;
+
+		// every buffer starts out free
+		WAVEHDR* header = (WAVEHDR*)headers;
+		for (int i = 0; i < AUDIO_DEVICE_BUFFERS; ++i) {
+			memset(&header[i], 0, sizeof(WAVEHDR));
+			header[i].dwFlags = WHDR_DONE;
+		}
+		next = 0;
+		return true;
+	}
+
+	void WaveOutAudioBackend::write(const float* samples, int frames) {
+		if (device == nullptr)
+			return;
+		WAVEHDR& header = ((WAVEHDR*)headers)[next];
+		// the device signals the event whenever it finishes a buffer
+		while (!(header.dwFlags & WHDR_DONE))
+			WaitForSingleObject((HANDLE)event, 100);
+		if (header.dwFlags & WHDR_PREPARED)
+			waveOutUnprepareHeader((HWAVEOUT)device, &header, sizeof(WAVEHDR));
+
+		std::vector<short>& buffer = buffers[next];
+		buffer.resize(frames * 2);
+		convertSamples(buffer.data(), samples, frames * 2);
+		header.lpData = (LPSTR)buffer.data();
+		header.dwBufferLength = (DWORD)(buffer.size() * sizeof(short));
+		header.dwFlags = 0;
+		waveOutPrepareHeader((HWAVEOUT)device, &header, sizeof(WAVEHDR));
+		waveOutWrite((HWAVEOUT)device, &header, sizeof(WAVEHDR));
+		next = (next + 1) % AUDIO_DEVICE_BUFFERS;
+		return;
+	}
+
+	void WaveOutAudioBackend::close() {
+		if (device == nullptr)
+			return;
+		// marks every queued buffer done
+		waveOutReset((HWAVEOUT)device);
+		WAVEHDR* header = (WAVEHDR*)headers;
+		for (int i = 0; i < AUDIO_DEVICE_BUFFERS; ++i)
+			if (header[i].dwFlags & WHDR_PREPARED)
+				waveOutUnprepareHeader((HWAVEOUT)device, &header[i], sizeof(WAVEHDR));
+		waveOutClose((HWAVEOUT)device);
+		CloseHandle((HANDLE)event);
+		device = nullptr;
+		event = nullptr;
+		return;
+	}
+#endif
+
+	AudioBackend* KDR_DefaultAudioBackend() {
+#ifdef _WIN32
+		return new WaveOutAudioBackend();
+#else
+		std::cout << "No audio device backend on this platform, audio will be silent" << std::endl;
+		return new NullAudioBackend(true);
+#endif
+	}
+}
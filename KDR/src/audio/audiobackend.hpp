@@ -0,0 +1,146 @@
+#ifndef _KDR_AUDIOBACKEND_HPP
+#define _KDR_AUDIOBACKEND_HPP
+
+#include <chrono>
+#include <fstream>
+#include <vector>
+
+/*
+ How many blocks a device queues at once
+ More is safer from crackling but adds latency
+ */
+#define AUDIO_DEVICE_BUFFERS (4)
+
+namespace kdr {
+	/*
+	 Where the mixer sends its audio
+	 Everything is 32 bit float stereo, left then right
+	 Make your own to play through another library
+	 */
+	class AudioBackend {
+	public:
+		virtual ~AudioBackend() {}
+
+		/*
+		 Gets ready to play
+		 Returns false if the device couldn't be opened
+		 */
+		virtual bool open(int sample_rate) = 0;
+
+		/*
+		 Plays frames of audio
+		 Should wait until the device has room for them,
+		 that's what keeps the mixer in time
+		 Called from the mixer's thread
+		 */
+		virtual void write(const float* samples, int frames) = 0;
+
+		/*
+		 Stops playing
+		 */
+		virtual void close() = 0;
+	};
+
+	/*
+	 Throws the audio away
+	 For headless runs and tests
+	 */
+	class NullAudioBackend : public AudioBackend {
+	protected:
+		/*
+		 Whether write waits as long as the audio would play
+		 */
+		bool realtime;
+		int sample_rate;
+		/*
+		 When the audio written so far would finish playing
+		 */
+		std::chrono::steady_clock::time_point deadline;
+
+	public:
+		/*
+		 @param realtime: wait as long as the audio would take to
+		 play, otherwise the mixer runs as fast as it can
+		 */
+		NullAudioBackend(bool realtime = true);
+
+		bool open(int sample_rate) override;
+		void write(const float* samples, int frames) override;
+		void close() override;
+	};
+
+	/*
+	 Writes the audio to a 16 bit WAV file
+	 For checking what the mixer made without speakers
+	 */
+	class FileAudioBackend : public NullAudioBackend {
+	private:
+		const char* file_path;
+		std::ofstream stream;
+		/*
+		 How many frames have been written
+		 */
+		unsigned int frames;
+		/*
+		 The samples converted to 16 bits
+		 */
+		std::vector<short> converted;
+
+		/*
+		 Writes the WAV header for the frames so far
+		 */
+		void writeHeader();
+
+	public:
+		/*
+		 @param file_path: the WAV file to write
+		 @param realtime: wait as long as the audio would take to play
+		 */
+		FileAudioBackend(const char* file_path, bool realtime = false);
+
+		bool open(int sample_rate) override;
+		void write(const float* samples, int frames) override;
+		void close() override;
+	};
+
+#ifdef _WIN32
+	/*
+	 Plays through the default device with waveOut
+	 */
+	class WaveOutAudioBackend : public AudioBackend {
+	private:
+		/*
+		 The HWAVEOUT, the event it signals when a
+		 buffer finishes and the WAVEHDRs, kept as void*
+		 so nobody else has to include windows.h
+		 */
+		void* device;
+		void* event;
+		void* headers;
+		/*
+		 The samples for each header
+		 */
+		std::vector<short> buffers[AUDIO_DEVICE_BUFFERS];
+		/*
+		 The next header to fill
+		 */
+		int next;
+
+	public:
+		WaveOutAudioBackend();
+		~WaveOutAudioBackend();
+
+		bool open(int sample_rate) override;
+		void write(const float* samples, int frames) override;
+		void close() override;
+	};
+#endif
+
+	/*
+	 Returns a backend for this platform's speakers, or a
+	 NullAudioBackend if KDR can't play on this platform
+	 */
+	AudioBackend* KDR_DefaultAudioBackend();
+}
+
+#endif // hi :)
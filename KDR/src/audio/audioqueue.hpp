@@ -0,0 +1,64 @@
+#ifndef _KDR_AUDIOQUEUE_HPP
+#define _KDR_AUDIOQUEUE_HPP
+
+#include <atomic>
+
+namespace kdr {
+	/*
+	 A lock-free queue with one thread pushing and one popping
+	 The same as InputQueue but for any type, so the game
+	 can talk to the mixer without it ever waiting on a lock
+	 @param SIZE: how many items it holds, has to be a power of 2
+	 */
+	template<typename T, unsigned int SIZE>
+	class AudioQueue {
+	private:
+		static_assert((SIZE & (SIZE - 1)) == 0, "AudioQueue's SIZE has to be a power of 2");
+
+		T items[SIZE];
+		/*
+		 The next item to pop, only written by the consumer
+		 */
+		std::atomic<unsigned int> head;
+		/*
+		 The next slot to push to, only written by the producer
+		 */
+		std::atomic<unsigned int> tail;
+
+	public:
+		AudioQueue()
+		: head(0), tail(0) {
+			return;
+		}
+
+		/*
+		 Adds an item to the back of the queue
+		 Returns false if the queue is full
+		 Only call from one thread
+		 */
+		bool push(const T& item) {
+			const unsigned int back = tail.load(std::memory_order_relaxed);
+			if (back - head.load(std::memory_order_acquire) >= SIZE)
+				return false;
+			items[back & (SIZE - 1)] = item;
+			tail.store(back + 1, std::memory_order_release);
+			return true;
+		}
+
+		/*
+		 Takes the item at the front of the queue
+		 Returns false if the queue is empty
+		 Only call from one thread
+		 */
+		bool pop(T& item) {
+			const unsigned int front = head.load(std::memory_order_relaxed);
+			if (front == tail.load(std::memory_order_acquire))
+				return false;
+			item = items[front & (SIZE - 1)];
+			head.store(front + 1, std::memory_order_release);
+			return true;
+		}
+	};
+}
+
+#endif // hi :)
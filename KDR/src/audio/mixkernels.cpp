@@ -0,0 +1,230 @@
+#include "mixkernels.hpp"
+#include "../util/simd.hpp"
+#include <algorithm>
+
+namespace kdr {
+	/*
+	 16 bit samples are scaled so -32768 is -1
+	 */
+	static const float SAMPLE_SCALE = 1.0f / 32768.0f;
+
+	/*
+	 The fraction of a 32.32 position, kept to 24 bits
+	 so it fits in a float exactly
+	 */
+	static inline float fractionOf(uint64_t position) {
+		return (float)((uint32_t)position >> 8) * (1.0f / 16777216.0f);
+	}
+
+	static inline float cubic(float before, float a, float b, float after, float t) {
+		return a + 0.5f * t * (b - before + t * (2.0f * before - 5.0f * a + 4.0f * b - after + t * (3.0f * (a - b) + after - before)));
+	}
+
+#ifdef KDR_SSE2
+	/*
+	 Adds 4 frames of left and right to stereo out
+	 */
+	static inline void accumulate4(float* out, __m128 left, __m128 right) {
+		_mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_unpacklo_ps(left, right)));
+		_mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), _mm_unpackhi_ps(left, right)));
+		return;
+	}
+
+	/*
+	 Works out the source frame and fraction of the next 4 positions
+	 */
+	static inline __m128 positions4(uint64_t& position, uint64_t step, int64_t* index) {
+		int fractions[4];
+		for (int k = 0; k < 4; ++k) {
+			index[k] = (int64_t)(position >> 32);
+			fractions[k] = (int)((uint32_t)position >> 8);
+			position += step;
+		}
+		return _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)fractions)), _mm_set1_ps(1.0f / 16777216.0f));
+	}
+
+	/*
+	 The same curve as cubic, 4 frames at once
+	 */
+	static inline __m128 cubic4(__m128 before, __m128 a, __m128 b, __m128 after, __m128 t) {
+		__m128 result = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(3.0f), _mm_sub_ps(a, b)), after), before);
+		result = _mm_add_ps(_mm_sub_ps(_mm_add_ps(_mm_sub_ps(_mm_add_ps(before, before), _mm_mul_ps(_mm_set1_ps(5.0f), a)), _mm_mul_ps(_mm_set1_ps(4.0f), b)), after), _mm_mul_ps(t, result));
+		result = _mm_add_ps(_mm_sub_ps(b, before), _mm_mul_ps(t, result));
+		return _mm_add_ps(a, _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), t), result));
+	}
+
+	/*
+	 Loads 2 floats into the low half
+	 */
+	static inline __m128 load2(const float* source) {
+		return _mm_castpd_ps(_mm_load_sd((const double*)source));
+	}
+#endif
+
+	void KDR_ConvertSamples(const int16_t* samples, float* out, int count) {
+		int i = 0;
+#ifdef KDR_SSE2
+		const __m128 scale = _mm_set1_ps(SAMPLE_SCALE);
+		for (; i + 8 <= count; i += 8) {
+			const __m128i packed = _mm_loadu_si128((const __m128i*)(samples + i));
+			// unpacking with itself then shifting down sign extends
+			const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+			const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(packed, packed), 16);
+			_mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+			_mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+		}
+#endif
+		for (; i < count; ++i)
+			out[i] = samples[i] * SAMPLE_SCALE;
+		return;
+	}
+
+	void KDR_MixSamples(const float* source, int channels, float gain_left, float gain_right, float* out, int frames) {
+		int i = 0;
+		if (channels == 2) {
+			const int count = frames * 2;
+#if defined(KDR_AVX)
+			const __m256 gains = _mm256_setr_ps(gain_left, gain_right, gain_left, gain_right, gain_left, gain_right, gain_left, gain_right);
+			for (; i + 8 <= count; i += 8)
+				_mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(out + i), _mm256_mul_ps(_mm256_loadu_ps(source + i), gains)));
+#elif defined(KDR_SSE2)
+			const __m128 gains = _mm_setr_ps(gain_left, gain_right, gain_left, gain_right);
+			for (; i + 4 <= count; i += 4)
+				_mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(_mm_loadu_ps(source + i), gains)));
+#endif
+			for (; i < count; i += 2) {
+				out[i] += source[i] * gain_left;
+				out[i + 1] += source[i + 1] * gain_right;
+			}
+			return;
+		}
+
+#if defined(KDR_AVX)
+		const __m256 gains = _mm256_setr_ps(gain_left, gain_right, gain_left, gain_right, gain_left, gain_right, gain_left, gain_right);
+		for (; i + 4 <= frames; i += 4) {
+			// each mono sample goes to both speakers
+			const __m128 mono = _mm_loadu_ps(source + i);
+			const __m256 doubled = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_unpacklo_ps(mono, mono)), _mm_unpackhi_ps(mono, mono), 1);
+			_mm256_storeu_ps(out + i * 2, _mm256_add_ps(_mm256_loadu_ps(out + i * 2), _mm256_mul_ps(doubled, gains)));
+		}
+#elif defined(KDR_SSE2)
+		const __m128 gains = _mm_setr_ps(gain_left, gain_right, gain_left, gain_right);
+		for (; i + 4 <= frames; i += 4) {
+			const __m128 mono = _mm_loadu_ps(source + i);
+			_mm_storeu_ps(out + i * 2, _mm_add_ps(_mm_loadu_ps(out + i * 2), _mm_mul_ps(_mm_unpacklo_ps(mono, mono), gains)));
+			_mm_storeu_ps(out + i * 2 + 4, _mm_add_ps(_mm_loadu_ps(out + i * 2 + 4), _mm_mul_ps(_mm_unpackhi_ps(mono, mono), gains)));
+		}
+#endif
+		for (; i < frames; ++i) {
+			out[i * 2] += source[i] * gain_left;
+			out[i * 2 + 1] += source[i] * gain_right;
+		}
+		return;
+	}
+
+	void KDR_MixLinear(const float* source, int channels, uint64_t position, uint64_t step, float gain_left, float gain_right, float* out, int frames) {
+		int i = 0;
+#ifdef KDR_SSE2
+		const __m128 gain_l = _mm_set1_ps(gain_left);
+		const __m128 gain_r = _mm_set1_ps(gain_right);
+		int64_t index[4];
+		for (; i + 4 <= frames; i += 4) {
+			const __m128 t = positions4(position, step, index);
+			__m128 left, right;
+			if (channels == 2) {
+				// each load is a frame and the one after it,
+				// transposing gives a vector of each
+				__m128 a_left = _mm_loadu_ps(source + index[0] * 2);
+				__m128 a_right = _mm_loadu_ps(source + index[1] * 2);
+				__m128 b_left = _mm_loadu_ps(source + index[2] * 2);
+				__m128 b_right = _mm_loadu_ps(source + index[3] * 2);
+				_MM_TRANSPOSE4_PS(a_left, a_right, b_left, b_right);
+				left = _mm_add_ps(a_left, _mm_mul_ps(_mm_sub_ps(b_left, a_left), t));
+				right = _mm_add_ps(a_right, _mm_mul_ps(_mm_sub_ps(b_right, a_right), t));
+			}
+			else {
+				const __m128 pairs_low = _mm_movelh_ps(load2(source + index[0]), load2(source + index[1]));
+				const __m128 pairs_high = _mm_movelh_ps(load2(source + index[2]), load2(source + index[3]));
+				const __m128 a = _mm_shuffle_ps(pairs_low, pairs_high, _MM_SHUFFLE(2, 0, 2, 0));
+				const __m128 b = _mm_shuffle_ps(pairs_low, pairs_high, _MM_SHUFFLE(3, 1, 3, 1));
+				left = right = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+			}
+			accumulate4(out + i * 2, _mm_mul_ps(left, gain_l), _mm_mul_ps(right, gain_r));
+		}
+#endif
+		for (; i < frames; ++i, position += step) {
+			const float* a = source + (position >> 32) * channels;
+			const float t = fractionOf(position);
+			const float left = a[0] + (a[channels] - a[0]) * t;
+			const float right = channels == 2 ? a[1] + (a[3] - a[1]) * t : left;
+			out[i * 2] += left * gain_left;
+			out[i * 2 + 1] += right * gain_right;
+		}
+		return;
+	}
+
+	void KDR_MixCubic(const float* source, int channels, uint64_t position, uint64_t step, float gain_left, float gain_right, float* out, int frames) {
+		int i = 0;
+#ifdef KDR_SSE2
+		const __m128 gain_l = _mm_set1_ps(gain_left);
+		const __m128 gain_r = _mm_set1_ps(gain_right);
+		int64_t index[4];
+		for (; i + 4 <= frames; i += 4) {
+			const __m128 t = positions4(position, step, index);
+			__m128 left, right;
+			if (channels == 2) {
+				__m128 before_left = _mm_loadu_ps(source + (index[0] - 1) * 2);
+				__m128 before_right = _mm_loadu_ps(source + (index[1] - 1) * 2);
+				__m128 a_left = _mm_loadu_ps(source + (index[2] - 1) * 2);
+				__m128 a_right = _mm_loadu_ps(source + (index[3] - 1) * 2);
+				_MM_TRANSPOSE4_PS(before_left, before_right, a_left, a_right);
+				__m128 b_left = _mm_loadu_ps(source + (index[0] + 1) * 2);
+				__m128 b_right = _mm_loadu_ps(source + (index[1] + 1) * 2);
+				__m128 after_left = _mm_loadu_ps(source + (index[2] + 1) * 2);
+				__m128 after_right = _mm_loadu_ps(source + (index[3] + 1) * 2);
+				_MM_TRANSPOSE4_PS(b_left, b_right, after_left, after_right);
+				left = cubic4(before_left, a_left, b_left, after_left, t);
+				right = cubic4(before_right, a_right, b_right, after_right, t);
+			}
+			else {
+				__m128 before = _mm_loadu_ps(source + index[0] - 1);
+				__m128 a = _mm_loadu_ps(source + index[1] - 1);
+				__m128 b = _mm_loadu_ps(source + index[2] - 1);
+				__m128 after = _mm_loadu_ps(source + index[3] - 1);
+				_MM_TRANSPOSE4_PS(before, a, b, after);
+				left = right = cubic4(before, a, b, after, t);
+			}
+			accumulate4(out + i * 2, _mm_mul_ps(left, gain_l), _mm_mul_ps(right, gain_r));
+		}
+#endif
+		for (; i < frames; ++i, position += step) {
+			const float* a = source + (position >> 32) * channels;
+			const float t = fractionOf(position);
+			const float left = cubic(a[-channels], a[0], a[channels], a[channels * 2], t);
+			const float right = channels == 2 ? cubic(a[-1], a[1], a[3], a[5], t) : left;
+			out[i * 2] += left * gain_left;
+			out[i * 2 + 1] += right * gain_right;
+		}
+		return;
+	}
+
+	void KDR_ClipSamples(float* samples, int count, float volume) {
+		int i = 0;
+#if defined(KDR_AVX)
+		const __m256 scale = _mm256_set1_ps(volume);
+		const __m256 low = _mm256_set1_ps(-1.0f);
+		const __m256 high = _mm256_set1_ps(1.0f);
+		for (; i + 8 <= count; i += 8)
+			_mm256_storeu_ps(samples + i, _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(samples + i), scale), low), high));
+#elif defined(KDR_SSE2)
+		const __m128 scale = _mm_set1_ps(volume);
+		const __m128 low = _mm_set1_ps(-1.0f);
+		const __m128 high = _mm_set1_ps(1.0f);
+		for (; i + 4 <= count; i += 4)
+			_mm_storeu_ps(samples + i, _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(samples + i), scale), low), high));
+#endif
+		for (; i < count; ++i)
+			samples[i] = std::min(std::max(samples[i] * volume, -1.0f), 1.0f);
+		return;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#ifndef _KDR_MIXKERNELS_HPP
+#define _KDR_MIXKERNELS_HPP
+
+#include <stdint.h>
+
+namespace kdr {
+	/*
+	 The mixer's inner loops
+	 Each uses SSE2 or AVX when util/simd.hpp finds them
+	 and plain loops otherwise
+	 Sources are float frames with 1 or 2 channels interleaved,
+	 outputs are stereo frames that get added to
+	 Positions are source frames in 32.32 fixed point
+	 */
+
+	/*
+	 Converts 16 bit samples to floats from -1 to 1
+	 */
+	void KDR_ConvertSamples(const int16_t* samples, float* out, int count);
+
+	/*
+	 Adds source to out with a gain for each speaker
+	 For sources already at the device's rate
+	 */
+	void KDR_MixSamples(const float* source, int channels, float gain_left, float gain_right, float* out, int frames);
+
+	/*
+	 Adds source to out, blending between the 2 nearest frames
+	 source has to have frames up to 1 past the last position
+	 */
+	void KDR_MixLinear(const float* source, int channels, uint64_t position, uint64_t step, float gain_left, float gain_right, float* out, int frames);
+
+	/*
+	 Adds source to out with a Catmull-Rom curve through the 4
+	 nearest frames, smoother than linear for big rate changes
+	 source has to have frames from 1 before the first position
+	 to 2 past the last
+	 */
+	void KDR_MixCubic(const float* source, int channels, uint64_t position, uint64_t step, float gain_left, float gain_right, float* out, int frames);
+
+	/*
+	 Scales samples by volume and clamps them from -1 to 1
+	 */
+	void KDR_ClipSamples(float* samples, int count, float volume);
+}
+
+#endif // hi :)
\ No newline at end of file
@@ -0,0 +1,32 @@
+#include "sound.hpp"
+#include "wavdecoder.hpp"
+
+namespace kdr {
+	Sound::Sound(const char* file_path)
+	: channels(0), sample_rate(0), frames(0) {
+		WavDecoder decoder;
+		if (!decoder.open(file_path))
+			return;
+
+		channels = decoder.getChannels();
+		sample_rate = decoder.getSampleRate();
+		samples.resize((size_t)decoder.getFrames() * channels);
+		// the header's size can be wrong, so only
+		// keep what could actually be read
+		uint32_t read = 0;
+		while (read < decoder.getFrames()) {
+			const int count = decoder.read(&samples[(size_t)read * channels], (int)(decoder.getFrames() - read));
+			if (count == 0)
+				break;
+			read += count;
+		}
+		samples.resize((size_t)read * channels);
+		frames = read;
+		return;
+	}
+
+	Sound::Sound(const int16_t* samples, uint32_t frames, int channels, int sample_rate)
+	: samples(samples, samples + (size_t)frames * channels), channels(channels), sample_rate(sample_rate), frames(frames) {
+		return;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef _KDR_SOUND_HPP
+#define _KDR_SOUND_HPP
+
+#include <vector>
+#include <stdint.h>
+
+namespace kdr {
+	/*
+	 A sound decoded all at once into memory
+	 For short effects that play often, stream
+	 music with KDR_PlayStream instead
+	 */
+	class Sound {
+	private:
+		/*
+		 16 bit samples, channels interleaved
+		 */
+		std::vector<int16_t> samples;
+		int channels;
+		int sample_rate;
+		uint32_t frames;
+
+	public:
+		/*
+		 Decodes a WAV file
+		 Prints why and has no frames if it can't be read
+		 */
+		Sound(const char* file_path);
+
+		/*
+		 Copies samples that were made in code
+		 @param samples: frames * channels 16 bit samples, channels interleaved
+		 */
+		Sound(const int16_t* samples, uint32_t frames, int channels, int sample_rate);
+
+		/*
+		 Returns true if the file was decoded
+		 */
+		inline bool isLoaded() const {
+			return frames > 0;
+		}
+
+		inline const int16_t* getSamples() const {
+			return samples.data();
+		}
+
+		inline int getChannels() const {
+			return channels;
+		}
+
+		inline int getSampleRate() const {
+			return sample_rate;
+		}
+
+		/*
+		 Returns how many frames the sound has,
+		 a frame is one sample for every channel
+		 */
+		inline uint32_t getFrames() const {
+			return frames;
+		}
+	};
+}
+
+#endif // hi :)
@@ -0,0 +1,147 @@
+#include "wavdecoder.hpp"
+#include <iostream>
+#include <string.h>
+
+namespace kdr {
+	/*
+	 The format codes the decoder understands
+	 */
+	static const uint16_t WAV_PCM = 1;
+	static const uint16_t WAV_FLOAT = 3;
+	static const uint16_t WAV_EXTENSIBLE = 0xFFFE;
+
+	static inline uint16_t readLE16(const unsigned char* bytes) {
+		return (uint16_t)(bytes[0] | bytes[1] << 8);
+	}
+
+	static inline uint32_t readLE32(const unsigned char* bytes) {
+		return (uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+	}
+
+	WavDecoder::WavDecoder()
+	: data_start(0), frames(0), frames_read(0), channels(0), sample_rate(0), bits_per_sample(0), is_float(false) {
+		return;
+	}
+
+	bool WavDecoder::open(const char* file_path) {
+		stream.close();
+		stream.clear();
+		stream.open(file_path, std::ios::binary);
+		if (!stream) {
+			std::cout << "Unable to open sound: " << file_path << std::endl;
+			return false;
+		}
+
+		unsigned char header[12];
+		if (!stream.read((char*)header, sizeof(header))) {
+			std::cout << "Unable to read sound: " << file_path << std::endl;
+			stream.close();
+			return false;
+		}
+		if (memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) {
+			if (memcmp(header, "OggS", 4) == 0)
+				std::cout << "Unable to read sound, it's Ogg Vorbis and only WAV is supported: " << file_path << std::endl;
+			else
+				std::cout << "Unable to read sound, it isn't a WAV file: " << file_path << std::endl;
+			stream.close();
+			return false;
+		}
+
+		// the chunks can come in any order, the
+		// samples are wherever "data" is
+		bool found_format = false;
+		uint16_t format = 0;
+		unsigned char chunk[8];
+		while (stream.read((char*)chunk, sizeof(chunk))) {
+			const uint32_t size = readLE32(chunk + 4);
+			if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+				unsigned char info[40] = { 0 };
+				stream.read((char*)info, size < sizeof(info) ? size : sizeof(info));
+				format = readLE16(info);
+				channels = readLE16(info + 2);
+				sample_rate = (int)readLE32(info + 4);
+				bits_per_sample = readLE16(info + 14);
+				// extensible files keep the real format in the sub format
+				if (format == WAV_EXTENSIBLE && size >= 26)
+					format = readLE16(info + 24);
+				found_format = true;
+				if (size > sizeof(info))
+					stream.seekg(size - sizeof(info), std::ios::cur);
+			}
+			else if (memcmp(chunk, "data", 4) == 0 && found_format) {
+				data_start = stream.tellg();
+				is_float = format == WAV_FLOAT;
+				const bool supported = (format == WAV_PCM && (bits_per_sample == 8 || bits_per_sample == 16 || bits_per_sample == 24))
+					|| (is_float && bits_per_sample == 32);
+				if (!supported || channels < 1 || channels > 2 || sample_rate <= 0) {
+					std::cout << "Unable to play sound, only 8, 16 and 24 bit or float mono or stereo WAV is supported: " << file_path << std::endl;
+					stream.close();
+					return false;
+				}
+				frames = size / (channels * bits_per_sample / 8);
+				frames_read = 0;
+				return true;
+			}
+			else
+				stream.seekg(size + (size & 1), std::ios::cur);
+		}
+
+		std::cout << "Unable to read sound, it has no samples: " << file_path << std::endl;
+		stream.close();
+		return false;
+	}
+
+	int WavDecoder::read(int16_t* samples, int count) {
+		if (!stream.is_open())
+			return 0;
+		if ((uint32_t)count > frames - frames_read)
+			count = (int)(frames - frames_read);
+		if (count <= 0)
+			return 0;
+
+		const int sample_count = count * channels;
+		const int bytes_per_sample = bits_per_sample / 8;
+		if (bits_per_sample == 16) {
+			// already the right format
+			stream.read((char*)samples, sample_count * 2);
+		}
+		else {
+			raw.resize(sample_count * bytes_per_sample);
+			stream.read((char*)raw.data(), raw.size());
+		}
+		count = (int)(stream.gcount() / (bytes_per_sample * channels));
+		frames_read += count;
+
+		const int read_samples = count * channels;
+		const unsigned char* bytes = raw.data();
+		switch (bits_per_sample) {
+		case 8:
+			// 8 bit samples are unsigned
+			for (int i = 0; i < read_samples; ++i)
+				samples[i] = (int16_t)((bytes[i] - 128) << 8);
+			break;
+		case 24:
+			for (int i = 0; i < read_samples; ++i)
+				samples[i] = (int16_t)readLE16(bytes + i * 3 + 1);
+			break;
+		case 32:
+			for (int i = 0; i < read_samples; ++i) {
+				float value;
+				memcpy(&value, bytes + i * 4, 4);
+				value = value < -1.0f ? -1.0f : value > 1.0f ? 1.0f : value;
+				samples[i] = (int16_t)(value * 32767.0f);
+			}
+			break;
+		}
+		return count;
+	}
+
+	bool WavDecoder::rewind() {
+		if (!stream.is_open())
+			return false;
+		stream.clear();
+		stream.seekg(data_start);
+		frames_read = 0;
+		return (bool)stream;
+	}
+}
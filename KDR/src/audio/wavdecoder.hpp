@@ -0,0 +1,77 @@
+#ifndef _KDR_WAVDECODER_HPP
+#define _KDR_WAVDECODER_HPP
+
+#include <fstream>
+#include <vector>
+#include <stdint.h>
+
+namespace kdr {
+	/*
+	 Reads a WAV file a few frames at a time
+	 Handles 8, 16 and 24 bit PCM and 32 bit float with 1 or 2
+	 channels, everything comes out as 16 bit samples
+	 A frame is one sample for every channel
+	 */
+	class WavDecoder {
+	private:
+		std::ifstream stream;
+		/*
+		 Where the samples start in the file
+		 */
+		std::streamoff data_start;
+		/*
+		 How many frames the file has and how many were read
+		 */
+		uint32_t frames;
+		uint32_t frames_read;
+		int channels;
+		int sample_rate;
+		int bits_per_sample;
+		bool is_float;
+		/*
+		 The file's bytes before they're converted
+		 */
+		std::vector<unsigned char> raw;
+
+	public:
+		WavDecoder();
+
+		/*
+		 Opens a WAV file and reads its header
+		 Returns false and prints why if it can't be played
+		 */
+		bool open(const char* file_path);
+
+		/*
+		 Reads up to count frames into samples, channels interleaved
+		 Returns how many frames were read, 0 at the end of the file
+		 */
+		int read(int16_t* samples, int count);
+
+		/*
+		 Goes back to the first frame
+		 */
+		bool rewind();
+
+		inline bool isOpen() const {
+			return stream.is_open();
+		}
+
+		inline int getChannels() const {
+			return channels;
+		}
+
+		inline int getSampleRate() const {
+			return sample_rate;
+		}
+
+		/*
+		 Returns how many frames the file has
+		 */
+		inline uint32_t getFrames() const {
+			return frames;
+		}
+	};
+}
+
+#endif // hi :)
@@ -2,8 +2,9 @@
 #include <iostream>
 
 namespace kdr {
-	Game::Game(const char* window_title, int width, int height, bool limit_framerate) {
-		window = new Window(*this, window_title, width, height, limit_framerate);
+	Game::Game(const char* window_title, int width, int height, bool limit_framerate, WindowBackend backend)
+	: window(nullptr) {
+		window = new Window(*this, window_title, width, height, limit_framerate, backend);
 		return;
 	}
 
@@ -4,6 +4,7 @@
 // TODO: Turn functions into pure virtual, mark Game abstract, remove game.cpp
 
 #include "gfx/window.hpp"
+#include "gameloop.hpp"
 
 namespace kdr {
 	/*
@@ -27,8 +28,9 @@ namespace kdr {
 		 @param height: the height of the screen in pixels
 		 @param limit_framerate: whether or not the game will
 		 be limited by vsync
+		 @param backend: what the window is made with
 		 */
-		Game(const char* window_title, int width, int height, bool limit_framerate);
+		Game(const char* window_title, int width, int height, bool limit_framerate, WindowBackend backend = WindowBackend::Glfw);
 
 		/*
 		 Allows a customizable Game to be made in initialization
@@ -40,6 +42,12 @@ namespace kdr {
 		 */
 		Window* window;
 
+		/*
+		 Runs update at a fixed rate and draw once a frame
+		 Games call loop.run(*this) from run
+		 */
+		GameLoop loop;
+
 		virtual void loadAssets() = 0;
 		virtual int run() = 0;
 		virtual void init() = 0;
@@ -0,0 +1,153 @@
+#include "gameloop.hpp"
+#include "game.hpp"
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <mmsystem.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "winmm.lib")
+#endif
+#endif
+
+namespace kdr {
+	const std::chrono::steady_clock::time_point loop_origin = std::chrono::steady_clock::now();
+
+	double KDR_LoopTime() {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - loop_origin).count();
+	}
+
+	GameLoop::GameLoop(double tick_rate)
+	: tick_time(1.0 / tick_rate), frame_time(0.0), accumulator(0.0), alpha(0.0f), max_ticks(8), ticks(0), running(false),
+	  idle(false), idle_timeout(0.5), dirty(true), animating(false) {
+		return;
+	}
+
+	void GameLoop::setTickRate(double tick_rate) {
+		tick_time = 1.0 / tick_rate;
+		return;
+	}
+
+	void GameLoop::setFrameCap(double frame_rate) {
+		frame_time = frame_rate > 0.0 ? 1.0 / frame_rate : 0.0;
+		return;
+	}
+
+	void GameLoop::setMaxTicksPerFrame(unsigned int max_ticks) {
+		this->max_ticks = max_ticks > 0 ? max_ticks : 1;
+		return;
+	}
+
+	void GameLoop::setIdleMode(bool idle, double timeout) {
+		this->idle = idle;
+		idle_timeout = timeout;
+		// draw once so the screen isn't left stale
+		dirty = true;
+		return;
+	}
+
+	void GameLoop::waitUntil(double deadline) const {
+		// sleep through most of the wait so the core is free
+		double remaining = deadline - KDR_LoopTime();
+		if (remaining > GAMELOOP_SPIN_TIME)
+			std::this_thread::sleep_for(std::chrono::duration<double>(remaining - GAMELOOP_SPIN_TIME));
+
+		// then spin through the rest since
+		// sleep is rarely on time
+		while (KDR_LoopTime() < deadline)
+			std::this_thread::yield();
+		return;
+	}
+
+	int GameLoop::run(Game& game) {
+		running = true;
+		accumulator = 0.0;
+		double previous = KDR_LoopTime();
+#ifdef _WIN32
+		// Windows wakes sleeping threads every 15.6ms by default,
+		// far past GAMELOOP_SPIN_TIME, so ask for 1ms while we run
+		timeBeginPeriod(1);
+#endif
+
+		while (running && game.window->isRunning()) {
+			// nothing to show, sleep until the player does something
+			if (idle && !dirty && !animating) {
+				game.window->waitEvents(idle_timeout);
+				const bool events = game.window->consumeEvents();
+
+				// the time spent asleep isn't simulated, a
+				// single tick handles whatever woke us up
+				previous = KDR_LoopTime();
+				accumulator = 0.0;
+				alpha = 0.0f;
+				game.update();
+				++ticks;
+
+				if (events || dirty || animating) {
+					game.draw();
+					game.window->draw();
+					dirty = false;
+				}
+				continue;
+			}
+
+			const double frame_start = KDR_LoopTime();
+			double elapsed = frame_start - previous;
+			previous = frame_start;
+			if (elapsed > GAMELOOP_MAX_FRAME_TIME)
+				elapsed = GAMELOOP_MAX_FRAME_TIME;
+			accumulator += elapsed;
+
+			// simulate every tick that's due
+			unsigned int frame_ticks = 0;
+			while (accumulator >= tick_time && running) {
+				game.update();
+				accumulator -= tick_time;
+				++ticks;
+
+				// if the ticks take longer than they simulate we'd
+				// never catch up, so drop the time we're behind
+				if (++frame_ticks >= max_ticks) {
+					accumulator = 0.0;
+					break;
+				}
+			}
+
+			alpha = (float)(accumulator / tick_time);
+			game.window->consumeEvents();
+			game.draw();
+			game.window->draw();
+			dirty = false;
+
+			if (frame_time > 0.0)
+				waitUntil(frame_start + frame_time);
+		}
+
+		running = false;
+#ifdef _WIN32
+		timeEndPeriod(1);
+#endif
+		return EXIT_SUCCESS;
+	}
+
+	double GameLoop::runHeadless(Game& game, unsigned long long tick_count) {
+		running = true;
+		alpha = 0.0f;
+		const double start = KDR_LoopTime();
+		for (unsigned long long i = 0; i < tick_count && running; ++i) {
+			game.update();
+			++ticks;
+		}
+		running = false;
+		return KDR_LoopTime() - start;
+	}
+
+	void GameLoop::stop() {
+		running = false;
+		return;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,182 @@
+#ifndef _KDR_GAMELOOP_HPP
+#define _KDR_GAMELOOP_HPP
+
+/*
+ The most time a single frame can add to the accumulator
+ in seconds, so a breakpoint or a dragged window doesn't
+ make the game run hundreds of ticks to catch up
+ */
+#define GAMELOOP_MAX_FRAME_TIME (0.25)
+
+/*
+ How long before a capped frame's deadline the loop stops
+ sleeping and spins instead, in seconds
+ Sleeping can overshoot by about a scheduler quantum,
+ on Windows run asks for a 1ms one so this is enough
+ */
+#define GAMELOOP_SPIN_TIME (0.002)
+
+namespace kdr {
+	class Game;
+
+	/*
+	 Runs a Game at a fixed simulation rate
+	 update is called once per tick no matter the framerate,
+	 draw is called once per frame and can smooth movement
+	 between the last two ticks with getAlpha
+	 */
+	class GameLoop {
+	private:
+		/*
+		 Seconds per tick
+		 */
+		double tick_time;
+		/*
+		 Seconds per frame, 0 when uncapped
+		 */
+		double frame_time;
+		/*
+		 Time that hasn't been simulated yet in seconds
+		 */
+		double accumulator;
+		/*
+		 How far the frame is between the last tick and
+		 the next one, from 0 to 1
+		 */
+		float alpha;
+		/*
+		 How many ticks can run in one frame
+		 */
+		unsigned int max_ticks;
+		/*
+		 Ticks run since the loop started
+		 */
+		unsigned long long ticks;
+		bool running;
+
+		/*
+		 Idle mode only draws when something changed
+		 and sleeps on the window's events otherwise
+		 */
+		bool idle;
+		double idle_timeout;
+		/*
+		 Set by game code when the next frame has to be drawn
+		 */
+		bool dirty;
+		/*
+		 Set by game code while something is moving so idle
+		 mode keeps ticking and drawing every frame
+		 */
+		bool animating;
+
+		/*
+		 Sleeps then spins until the deadline
+		 @param deadline: seconds from KDR_LoopTime
+		 */
+		void waitUntil(double deadline) const;
+
+	public:
+		/*
+		 @param tick_rate: how many times a second update is called
+		 */
+		GameLoop(double tick_rate = 60.0);
+
+		/*
+		 Sets how many times a second update is called
+		 */
+		void setTickRate(double tick_rate);
+
+		/*
+		 Caps how many frames are drawn a second
+		 Useful when vsync is off so the game doesn't
+		 spin a core drawing frames nobody sees
+		 @param frame_rate: 0 to uncap
+		 */
+		void setFrameCap(double frame_rate);
+
+		/*
+		 Sets how many ticks can run in one frame before the
+		 loop gives up catching up and slows the game down instead
+		 */
+		void setMaxTicksPerFrame(unsigned int max_ticks);
+
+		/*
+		 Turns idle mode on or off
+		 In idle mode the loop sleeps until input arrives, the
+		 timeout passes, or the game is dirty or animating
+		 Each wake runs one tick and only draws if there was input,
+		 the game was marked dirty, or it's animating
+		 Made for turn based games that mostly wait on the player
+		 @param timeout: the most seconds to sleep before running
+		 a tick anyway, so timers still move
+		 */
+		void setIdleMode(bool idle, double timeout = 0.5);
+
+		/*
+		 Makes idle mode draw the next frame
+		 */
+		inline void markDirty() {
+			dirty = true;
+		}
+
+		/*
+		 Keeps idle mode running and drawing at the normal
+		 rate while true, IE during an animation
+		 */
+		inline void setAnimating(bool animating) {
+			this->animating = animating;
+		}
+
+		/*
+		 Runs the game until its window closes or stop is called
+		 Returns EXIT_SUCCESS
+		 */
+		int run(Game& game);
+
+		/*
+		 Runs ticks back to back as fast as possible without
+		 drawing or waiting, for simulation benchmarks and tests
+		 Stops early if stop is called
+		 Returns how many seconds the ticks took
+		 @param tick_count: how many ticks to run
+		 */
+		double runHeadless(Game& game, unsigned long long tick_count);
+
+		/*
+		 Ends run or runHeadless after the current tick
+		 */
+		void stop();
+
+		/*
+		 Returns how far the current frame is between the
+		 last tick and the next one, from 0 to 1
+		 Draw things at lerp(previous, current, alpha)
+		 */
+		inline float getAlpha() const {
+			return alpha;
+		}
+
+		/*
+		 Returns the seconds every tick simulates
+		 */
+		inline double getTickTime() const {
+			return tick_time;
+		}
+
+		/*
+		 Returns how many ticks have run
+		 */
+		inline unsigned long long getTicks() const {
+			return ticks;
+		}
+	};
+
+	/*
+	 Returns the seconds since the first call
+	 from a monotonic high resolution clock
+	 */
+	double KDR_LoopTime();
+}
+
+#endif // hi :)
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef _KDR_CAPTUREFORMAT_HPP
+#define _KDR_CAPTUREFORMAT_HPP
+
+namespace kdr {
+	/*
+	 How a captured frame is written
+	 */
+	enum class CaptureFormat {
+		/*
+		 A PNG file per frame
+		 */
+		Png,
+		/*
+		 The RGBA rows, top row first, appended to the file
+		 A whole dump goes into one file that ffmpeg can read with
+		 -f rawvideo -pixel_format rgba -video_size WIDTHxHEIGHT
+		 */
+		Raw
+	};
+}
+
+#endif // hi :)
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "dirtyregion.hpp"
+#include <GL/glew.h>
+
+namespace kdr {
+	/*
+	 Returns true if the rectangles overlap or share an edge
+	 */
+	static inline bool touches(const Rectangle& a, const Rectangle& b) {
+		return a.x <= b.x + b.width && b.x <= a.x + a.width
+			&& a.y <= b.y + b.height && b.y <= a.y + a.height;
+	}
+
+	/*
+	 Returns the rectangle around both rectangles
+	 */
+	static inline Rectangle merge(const Rectangle& a, const Rectangle& b) {
+		const float left   = a.x < b.x ? a.x : b.x;
+		const float top    = a.y < b.y ? a.y : b.y;
+		const float right  = a.x + a.width  > b.x + b.width  ? a.x + a.width  : b.x + b.width;
+		const float bottom = a.y + a.height > b.y + b.height ? a.y + a.height : b.y + b.height;
+		return Rectangle(left, top, right - left, bottom - top);
+	}
+
+	DirtyRegion::DirtyRegion(int width, int height, unsigned int buffer_age)
+	: buffer_age(buffer_age > DIRTY_MAX_AGE ? DIRTY_MAX_AGE : buffer_age), width(width), height(height) {
+		rects.reserve(DIRTY_MAX_RECTS);
+		redraw.reserve(DIRTY_MAX_RECTS);
+		markAll();
+		return;
+	}
+
+	void DirtyRegion::add(std::vector<Rectangle>& list, Rectangle rect) {
+		// keep merging until the rectangle
+		// doesn't touch anything else
+		for (unsigned int i = 0; i < list.size();) {
+			if (touches(list[i], rect)) {
+				rect = merge(list[i], rect);
+				list[i] = list.back();
+				list.pop_back();
+				i = 0;
+			}
+			else
+				++i;
+		}
+
+		// too many small rectangles cost more in
+		// draw calls than one big one costs in pixels
+		if (list.size() >= DIRTY_MAX_RECTS) {
+			for (const Rectangle& other : list)
+				rect = merge(other, rect);
+			list.clear();
+		}
+		list.push_back(rect);
+		return;
+	}
+
+	void DirtyRegion::resize(int width, int height) {
+		this->width = width;
+		this->height = height;
+		markAll();
+		return;
+	}
+
+	void DirtyRegion::setBufferAge(unsigned int buffer_age) {
+		buffer_age = buffer_age > DIRTY_MAX_AGE ? DIRTY_MAX_AGE : buffer_age;
+		// the same age every frame keeps the history
+		if (buffer_age == this->buffer_age)
+			return;
+		this->buffer_age = buffer_age;
+		markAll();
+		return;
+	}
+
+	void DirtyRegion::mark(const Rectangle& rect) {
+		if (rect.width <= 0.0f || rect.height <= 0.0f)
+			return;
+		add(rects, rect);
+		return;
+	}
+
+	void DirtyRegion::markTile(const TileData& tiles, int x, int y) {
+		// same position BatchRenderer draws tiles at
+		mark(Rectangle(
+			(float)((x + tiles.offset_x) * tiles.tile_size),
+			(float)((y + tiles.offset_y) * tiles.tile_size),
+			(float)tiles.tile_size, (float)tiles.tile_size));
+		return;
+	}
+
+	void DirtyRegion::markAll() {
+		rects.clear();
+		rects.push_back(Rectangle(0.0f, 0.0f, (float)width, (float)height));
+		return;
+	}
+
+	bool DirtyRegion::begin() {
+		redraw.clear();
+		if (buffer_age == 0) {
+			redraw.push_back(Rectangle(0.0f, 0.0f, (float)width, (float)height));
+		}
+		else {
+			// the buffer is missing this frame's changes
+			// and those of every frame since it was drawn
+			for (const Rectangle& rect : rects)
+				add(redraw, rect);
+			for (unsigned int i = 0; i + 1 < buffer_age; ++i)
+				for (const Rectangle& rect : history[i])
+					add(redraw, rect);
+		}
+
+		if (redraw.empty())
+			return false;
+		glEnable(GL_SCISSOR_TEST);
+		return true;
+	}
+
+	void DirtyRegion::scissor(unsigned int index) const {
+		const Rectangle& rect = redraw[index];
+		// OpenGL's scissor starts at the bottom left
+		// just like KDR's screen, so nothing is flipped
+		glScissor((GLint)rect.x, (GLint)rect.y, (GLsizei)rect.width, (GLsizei)rect.height);
+		return;
+	}
+
+	void DirtyRegion::end() {
+		glDisable(GL_SCISSOR_TEST);
+
+		// the oldest changes fall off, swap keeps
+		// each vector's memory around
+		for (unsigned int i = DIRTY_MAX_AGE - 1; i > 0; --i)
+			history[i].swap(history[i - 1]);
+		history[0].swap(rects);
+		rects.clear();
+		return;
+	}
+}
\ No newline at end of file
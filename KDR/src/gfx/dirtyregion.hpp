@@ -0,0 +1,148 @@
+#ifndef _KDR_DIRTYREGION_HPP
+#define _KDR_DIRTYREGION_HPP
+
+#include <vector>
+#include "rectangle.hpp"
+#include "renderers/renderer.hpp"
+
+/*
+ The most rectangles kept apart before they're
+ merged into one rectangle around all of them
+ */
+#define DIRTY_MAX_RECTS (16)
+
+/*
+ The most frames a buffer can be behind
+ the one being drawn
+ */
+#define DIRTY_MAX_AGE (4)
+
+namespace kdr {
+	/*
+	 Tracks which parts of the screen changed so only
+	 those parts are cleared and drawn again
+	 Mark what changes while updating, then draw:
+
+	 if (dirty.begin()) {
+		for (unsigned int i = 0; i < dirty.getCount(); ++i) {
+			dirty.scissor(i);
+			renderer->setCullBounds(dirty.get(i));
+			window->clear();
+			// draw everything, the renderer skips
+			// what's outside of the rectangle
+		}
+	 }
+	 dirty.end();
+	 */
+	class DirtyRegion {
+	private:
+		/*
+		 What changed this frame
+		 */
+		std::vector<Rectangle> rects;
+		/*
+		 What changed in the frames before, since the
+		 buffer being drawn to may not have them yet
+		 history[0] is the last frame
+		 */
+		std::vector<Rectangle> history[DIRTY_MAX_AGE];
+		/*
+		 The rectangles that have to be drawn this frame
+		 Filled by begin
+		 */
+		std::vector<Rectangle> redraw;
+		/*
+		 How many frames old the buffer's contents are
+		 0 means its contents can't be trusted
+		 */
+		unsigned int buffer_age;
+		/*
+		 The size of the buffer in pixels
+		 */
+		int width, height;
+
+		/*
+		 Adds a rectangle to a list, merging it with any
+		 rectangle it touches
+		 */
+		static void add(std::vector<Rectangle>& list, Rectangle rect);
+
+	public:
+		/*
+		 @param width: the width of what's being drawn to in pixels
+		 @param height: the height of what's being drawn to in pixels
+		 @param buffer_age: how many frames old the buffer is when
+		 drawing starts, 0 redraws everything every frame
+		 A window's back buffer is undefined after a swap unless
+		 the driver says otherwise, so only pass its age once it's
+		 been queried with EGL_EXT_buffer_age or GLX_EXT_buffer_age
+		 1 for a RenderTarget that's kept between frames
+		 */
+		DirtyRegion(int width, int height, unsigned int buffer_age = 0);
+
+		/*
+		 Changes the size of the buffer
+		 and marks all of it
+		 */
+		void resize(int width, int height);
+
+		/*
+		 Changes how many frames old the buffer is
+		 and marks all of it if the age changed
+		 Call it every frame with the queried age if
+		 the swap chain's age can change
+		 */
+		void setBufferAge(unsigned int buffer_age);
+
+		/*
+		 Marks a rectangle of pixels as changed
+		 */
+		void mark(const Rectangle& rect);
+
+		/*
+		 Marks a tile as changed
+		 @param tiles: the tile information of the renderer
+		 that draws the tile
+		 */
+		void markTile(const TileData& tiles, int x, int y);
+
+		/*
+		 Marks the whole buffer as changed
+		 */
+		void markAll();
+
+		/*
+		 Works out what has to be drawn this frame
+		 and turns on the scissor test
+		 Returns false if nothing has to be drawn
+		 */
+		bool begin();
+
+		/*
+		 Returns how many rectangles have to be drawn
+		 */
+		inline unsigned int getCount() const {
+			return (unsigned int)redraw.size();
+		}
+
+		/*
+		 Returns a rectangle that has to be drawn
+		 */
+		inline const Rectangle& get(unsigned int index) const {
+			return redraw[index];
+		}
+
+		/*
+		 Limits drawing to a rectangle that has to be drawn
+		 */
+		void scissor(unsigned int index) const;
+
+		/*
+		 Turns off the scissor test and moves
+		 this frame's changes into the history
+		 */
+		void end();
+	};
+}
+
+#endif // hi :)
\ No newline at end of file
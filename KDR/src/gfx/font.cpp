@@ -2,13 +2,15 @@
 #include <vector>
 #include <vcruntime_exception.h>
 #include <iostream>
+#include "../util/profiler.hpp"
 
 namespace kdr {
-	Font::Font(const char* ref_name, const char* file_path, GLuint size)
-	: ref_name(ref_name), size(size) {
+	Font::Font(const char* ref_name, const char* file_path, GLuint size, bool upload)
+	: ref_name(ref_name), size(size), upload(upload) {
 		atlas  = ftgl::texture_atlas_new(ATLAS_WIDTH, ATLAS_HEIGHT, ATLAS_CHANNELS);
 		ftFont = ftgl::texture_font_new_from_file(atlas, size, file_path);
-		texture_atlas_upload(atlas);
+		if (upload)
+			texture_atlas_upload(atlas);
 		//texture_atlas_upload(atlas);
 		return;
 	}
@@ -19,6 +21,30 @@ namespace kdr {
 		return;
 	}
 
+	ftgl::texture_glyph_t* Font::getGlyph(const char c) const {
+		bool missed;
+		return getGlyph(c, missed);
+	}
+
+	ftgl::texture_glyph_t* Font::getGlyph(const char c, bool& missed) const {
+		const size_t loaded = ftFont->glyphs->size;
+#ifndef KDR_NO_PROFILER
+		const double start = KDR_ProfilerTime();
+#endif
+		ftgl::texture_glyph_t* glyph = ftgl::texture_font_get_glyph(ftFont, c);
+		// if ftgl had to load the glyph, the atlas changed
+		// and OpenGL needs the new copy
+		missed = ftFont->glyphs->size != loaded;
+		if (missed) {
+			if (upload)
+				ftgl::texture_atlas_upload(atlas);
+#ifndef KDR_NO_PROFILER
+			KDR_ProfilerRecord("Font::loadGlyph", start);
+#endif
+		}
+		return glyph;
+	}
+
 	std::vector<Font*> fonts = std::vector<Font*>();
 
 	Font* KDR_AddFont(Font* font) {
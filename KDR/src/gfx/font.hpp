@@ -35,6 +35,11 @@ namespace kdr {
 		 */
 		GLuint size;
 
+		/*
+		 If the atlas is sent to OpenGL when it changes
+		 */
+		bool upload;
+
 	public:
 		/*
 		 Wrapper class which contains information for
@@ -42,8 +47,10 @@ namespace kdr {
 		 @param ref_name: the name of reference for future lookup
 		 @param file_path: the path to the TTF file
 		 @param size: size of the font
+		 @param upload: false keeps the atlas in memory only
+		 so the font can be used without an OpenGL context
 		 */
-		Font(const char* ref_name, const char* file_path, GLuint size);
+		Font(const char* ref_name, const char* file_path, GLuint size, bool upload = true);
 		/*
 		 Deletes the texture atlas and the ftgl font
 		 */
@@ -56,6 +63,14 @@ namespace kdr {
 			return atlas->id;
 		}
 
+		/*
+		 Returns the atlas the glyphs are packed onto
+		 Its data is 2 bytes a pixel, luminance then alpha
+		 */
+		inline const ftgl::texture_atlas_t* getAtlas() const {
+			return atlas;
+		}
+
 		/*
 		 Returns the ftgl font that this font is using
 		 */
@@ -73,6 +88,22 @@ namespace kdr {
 		inline const char* getName() const {
 			return ref_name;
 		}
+
+		/*
+		 Returns the glyph of the character, loading it
+		 into the atlas and uploading the atlas if the
+		 glyph hasn't been loaded yet
+		 Returns nullptr if the glyph can't be loaded
+		 */
+		ftgl::texture_glyph_t* getGlyph(const char c) const;
+
+		/*
+		 Returns the glyph of the character, loading it
+		 into the atlas and uploading the atlas if the
+		 glyph hasn't been loaded yet
+		 @param missed: set to true if the glyph had to be loaded
+		 */
+		ftgl::texture_glyph_t* getGlyph(const char c, bool& missed) const;
 	};
 
 	/*
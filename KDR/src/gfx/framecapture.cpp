@@ -0,0 +1,213 @@
+#include "framecapture.hpp"
+#include "../util/pngwriter.hpp"
+#include <fstream>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+
+namespace kdr {
+	FrameCapture::FrameCapture()
+	: first_slot(0), used_slots(0), dump_digits(0), dump_format(CaptureFormat::Raw), dump_frame(0), dropped(0), running(true) {
+		for (Slot& slot : slots) {
+			glGenBuffers(1, &slot.buffer);
+			slot.fence = nullptr;
+			slot.width = slot.height = 0;
+			slot.capacity = 0;
+		}
+		worker = std::thread(&FrameCapture::work, this);
+		return;
+	}
+
+	FrameCapture::~FrameCapture() {
+		// frames already asked for still get written
+		while (used_slots > 0)
+			collect(true);
+
+		{
+			std::lock_guard<std::mutex> lock(jobs_mutex);
+			running = false;
+		}
+		jobs_changed.notify_one();
+		if (worker.joinable())
+			worker.join();
+
+		for (Slot& slot : slots)
+			glDeleteBuffers(1, &slot.buffer);
+		return;
+	}
+
+	void FrameCapture::request(const char* file_path, CaptureFormat format) {
+		requests.push_back(std::make_pair(std::string(file_path), format));
+		return;
+	}
+
+	bool FrameCapture::startDump(const char* file_path, CaptureFormat format) {
+		if (format == CaptureFormat::Png) {
+			// the pattern is split up here and the names are built
+			// with a fixed format, so the path can't add conversions
+			const char* percent = strchr(file_path, '%');
+			const char* end = percent != nullptr ? percent + 1 : nullptr;
+			int digits = 0;
+			while (end != nullptr && *end >= '0' && *end <= '9' && digits < 100)
+				digits = digits * 10 + (*end++ - '0');
+			if (end == nullptr || *end != 'u' || digits > 10 || strchr(end, '%') != nullptr) {
+				std::cout << "Frame dump pattern needs a single %u: " << file_path << std::endl;
+				return false;
+			}
+			dump_prefix.assign(file_path, percent);
+			dump_suffix = end + 1;
+			dump_digits = digits;
+		}
+
+		dump_path = file_path;
+		dump_format = format;
+		dump_frame = 0;
+		// raw frames are appended, so start with an empty file
+		if (format == CaptureFormat::Raw)
+			std::ofstream(file_path, std::ios::binary | std::ios::trunc);
+		return true;
+	}
+
+	void FrameCapture::stopDump() {
+		dump_path.clear();
+		return;
+	}
+
+	void FrameCapture::readback(int width, int height) {
+		// hand over whatever the GPU has finished
+		while (used_slots > 0 && collect(false));
+
+		if (!dump_path.empty()) {
+			if (dump_format == CaptureFormat::Png) {
+				char file_path[512];
+				snprintf(file_path, sizeof(file_path), "%s%0*u%s", dump_prefix.c_str(), dump_digits, dump_frame, dump_suffix.c_str());
+				requests.push_back(std::make_pair(std::string(file_path), dump_format));
+			}
+			else
+				requests.push_back(std::make_pair(dump_path, dump_format));
+			++dump_frame;
+		}
+		if (requests.empty())
+			return;
+
+		// every slot is in use, wait for the oldest
+		// rather than lose the frame
+		if (used_slots == CAPTURE_RING_SIZE)
+			collect(true);
+
+		// a frame asked for more than once is read
+		// once and written for each request in collect
+		Slot& slot = slots[(first_slot + used_slots) % CAPTURE_RING_SIZE];
+		const size_t size = (size_t)width * height * 4;
+		slot.width = width;
+		slot.height = height;
+		slot.targets.swap(requests);
+		requests.clear();
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+		if (slot.capacity < size) {
+			glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+			slot.capacity = size;
+		}
+		// with a pack buffer bound this returns right away
+		// and the GPU copies into the buffer when it gets to it
+		glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		++used_slots;
+		return;
+	}
+
+	bool FrameCapture::collect(bool wait) {
+		Slot& slot = slots[first_slot];
+		GLenum result = glClientWaitSync(slot.fence, 0, 0);
+		if (result == GL_TIMEOUT_EXPIRED) {
+			if (!wait)
+				return false;
+			// flush so the fence can't wait on commands that were never sent
+			do {
+				result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+			} while (result == GL_TIMEOUT_EXPIRED);
+		}
+		glDeleteSync(slot.fence);
+		slot.fence = nullptr;
+		first_slot = (first_slot + 1) % CAPTURE_RING_SIZE;
+		--used_slots;
+
+		// skip copying out a frame nobody has room for
+		{
+			std::lock_guard<std::mutex> lock(jobs_mutex);
+			if (jobs.size() >= CAPTURE_MAX_PENDING) {
+				dropped += (unsigned int)slot.targets.size();
+				slot.targets.clear();
+				return true;
+			}
+		}
+
+		// every request for the frame shares the one copy
+		std::shared_ptr<std::vector<unsigned char>> frame_pixels = std::make_shared<std::vector<unsigned char>>((size_t)slot.width * slot.height * 4);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+		const void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frame_pixels->size(), GL_MAP_READ_BIT);
+		if (pixels != nullptr) {
+			memcpy(frame_pixels->data(), pixels, frame_pixels->size());
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		if (pixels == nullptr) {
+			std::cout << "Unable to map captured frame: " << slot.targets[0].first << std::endl;
+			slot.targets.clear();
+			return true;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(jobs_mutex);
+			for (const std::pair<std::string, CaptureFormat>& target : slot.targets) {
+				if (jobs.size() >= CAPTURE_MAX_PENDING) {
+					++dropped;
+					continue;
+				}
+				Job job;
+				job.file_path = target.first;
+				job.format = target.second;
+				job.width = slot.width;
+				job.height = slot.height;
+				job.pixels = frame_pixels;
+				jobs.push_back(std::move(job));
+			}
+		}
+		slot.targets.clear();
+		jobs_changed.notify_one();
+		return true;
+	}
+
+	void FrameCapture::work() {
+		std::unique_lock<std::mutex> lock(jobs_mutex);
+		while (true) {
+			jobs_changed.wait(lock, [this] { return !jobs.empty() || !running; });
+			// only stops once everything is written
+			if (jobs.empty())
+				break;
+			Job job = std::move(jobs.front());
+			jobs.pop_front();
+			lock.unlock();
+
+			bool written = false;
+			if (job.format == CaptureFormat::Png) {
+				// OpenGL's first row is the bottom
+				written = KDR_WritePNG(job.file_path.c_str(), job.pixels->data(), job.width, job.height, 0, true);
+			}
+			else {
+				std::ofstream stream(job.file_path, std::ios::binary | std::ios::app);
+				const size_t row_size = (size_t)job.width * 4;
+				for (int y = job.height - 1; y >= 0 && stream; --y)
+					stream.write((const char*)job.pixels->data() + row_size * y, row_size);
+				written = (bool)stream;
+			}
+			if (!written)
+				std::cout << "Unable to write captured frame: " << job.file_path << std::endl;
+
+			lock.lock();
+		}
+		return;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,172 @@
+#ifndef _KDR_FRAMECAPTURE_HPP
+#define _KDR_FRAMECAPTURE_HPP
+
+#include <GL/glew.h>
+#include "captureformat.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ How many frames can be read back at once
+ The GPU usually finishes a frame within 2
+ */
+#define CAPTURE_RING_SIZE (3)
+
+/*
+ How many frames can wait to be encoded before
+ new ones are dropped, so a slow disk can't
+ use up all the memory
+ */
+#define CAPTURE_MAX_PENDING (16)
+
+namespace kdr {
+	/*
+	 Reads frames back from OpenGL without stalling
+	 glReadPixels writes into a pixel buffer object and a fence
+	 tells when the GPU is done, a few frames later the pixels are
+	 copied out and written by a worker thread
+	 Owned by Window, use Window::captureFrame
+	 */
+	class FrameCapture {
+	private:
+		/*
+		 A pixel buffer being read into
+		 */
+		struct Slot {
+			GLuint buffer;
+			GLsync fence;
+			int width, height;
+			size_t capacity;
+			/*
+			 Every file the frame is written to
+			 */
+			std::vector<std::pair<std::string, CaptureFormat>> targets;
+		};
+
+		/*
+		 A frame waiting for the worker
+		 */
+		struct Job {
+			std::string file_path;
+			CaptureFormat format;
+			int width, height;
+			/*
+			 Shared by every job of the same frame
+			 */
+			std::shared_ptr<const std::vector<unsigned char>> pixels;
+		};
+
+		/*
+		 The pixel buffers, used oldest first
+		 */
+		Slot slots[CAPTURE_RING_SIZE];
+		/*
+		 The oldest slot still being read and how many are
+		 */
+		int first_slot;
+		int used_slots;
+
+		/*
+		 The captures asked for since the last readback
+		 */
+		std::vector<std::pair<std::string, CaptureFormat>> requests;
+
+		/*
+		 The frame dump, every frame is captured while the path isn't empty
+		 PNG names are dump_prefix, the frame's number with
+		 dump_digits digits, then dump_suffix
+		 */
+		std::string dump_path, dump_prefix, dump_suffix;
+		int dump_digits;
+		CaptureFormat dump_format;
+		unsigned int dump_frame;
+
+		/*
+		 The frames for the worker to write
+		 */
+		std::deque<Job> jobs;
+		std::mutex jobs_mutex;
+		std::condition_variable jobs_changed;
+
+		/*
+		 Frames dropped because too many were waiting
+		 */
+		std::atomic<unsigned int> dropped;
+
+		/*
+		 Whether the worker should keep waiting for jobs
+		 */
+		bool running;
+
+		/*
+		 The thread that writes the frames
+		 */
+		std::thread worker;
+
+		/*
+		 Writes jobs until running is false and there are none left
+		 */
+		void work();
+
+		/*
+		 Copies the oldest slot's pixels out and gives them to the worker
+		 @param wait: whether to wait for the GPU if it isn't done
+		 Returns false if it wasn't done
+		 */
+		bool collect(bool wait);
+
+	public:
+		/*
+		 Makes the pixel buffers and starts the worker
+		 Needs an OpenGL context
+		 */
+		FrameCapture();
+
+		/*
+		 Writes every frame still being read
+		 and waits for the worker to finish
+		 */
+		~FrameCapture();
+
+		/*
+		 Captures the next frame read back
+		 */
+		void request(const char* file_path, CaptureFormat format);
+
+		/*
+		 Captures every frame until stopDump
+		 @param file_path: a single file for raw frames,
+		 a pattern with a single %u or %0Nu for PNGs IE "dump/frame%06u.png"
+		 Returns false if a PNG pattern doesn't have one
+		 */
+		bool startDump(const char* file_path, CaptureFormat format);
+
+		/*
+		 Stops capturing every frame
+		 */
+		void stopDump();
+
+		/*
+		 Starts reading the back buffer if anything asked for it
+		 and hands finished frames to the worker
+		 Call after drawing and before swapping buffers
+		 */
+		void readback(int width, int height);
+
+		/*
+		 Returns how many frames were dropped
+		 because the worker fell behind
+		 */
+		inline unsigned int getDropped() const {
+			return dropped;
+		}
+	};
+}
+
+#endif // hi :)
\ No newline at end of file
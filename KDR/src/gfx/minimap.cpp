@@ -0,0 +1,56 @@
+#include "minimap.hpp"
+
+namespace kdr {
+	Minimap::Minimap(int width, int height, unsigned int color)
+	: texture(new Texture(width, height)), colors(width * height, color), width(width), height(height) {
+		// the new texture is undefined, so the first
+		// upload has to send the whole map
+		min_x = 0;
+		min_y = 0;
+		max_x = width - 1;
+		max_y = height - 1;
+		upload();
+		return;
+	}
+
+	Minimap::~Minimap() {
+		delete texture;
+		return;
+	}
+
+	void Minimap::setTile(int x, int y, unsigned int color) {
+		if (x < 0 || y < 0 || x >= width || y >= height)
+			return;
+		unsigned int& tile = colors[y * width + x];
+		if (tile == color)
+			return;
+		tile = color;
+
+		min_x = x < min_x ? x : min_x;
+		min_y = y < min_y ? y : min_y;
+		max_x = x > max_x ? x : max_x;
+		max_y = y > max_y ? y : max_y;
+		return;
+	}
+
+	void Minimap::upload() {
+		if (min_x > max_x || min_y > max_y)
+			return;
+
+		// only send the box that changed, the row length
+		// lets OpenGL step over the rest of each row
+		texture->bind();
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, width);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, min_x, min_y, max_x - min_x + 1, max_y - min_y + 1,
+			GL_RGBA, GL_UNSIGNED_BYTE, &colors[min_y * width + min_x]);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		texture->unbind();
+
+		min_x = width;
+		min_y = height;
+		max_x = -1;
+		max_y = -1;
+		return;
+	}
+}
\ No newline at end of file
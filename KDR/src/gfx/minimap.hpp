@@ -0,0 +1,91 @@
+#ifndef _KDR_MINIMAP_HPP
+#define _KDR_MINIMAP_HPP
+
+#include <vector>
+#include "texture.hpp"
+
+namespace kdr {
+	/*
+	 A texture with one texel per map tile
+	 Set the color of tiles as they change, upload once a frame
+	 and draw the texture as a single square with any Renderer
+	 Only the part of the texture that changed is uploaded
+	 */
+	class Minimap {
+	private:
+		/*
+		 The texture the minimap is drawn with
+		 */
+		Texture* texture;
+		/*
+		 The color of every tile, row by row
+		 Kept so uploads can send part of the map
+		 */
+		std::vector<unsigned int> colors;
+		/*
+		 The size of the map in tiles
+		 */
+		int width, height;
+		/*
+		 The box around every tile that changed since the last upload
+		 min is past max when nothing changed
+		 */
+		int min_x, min_y, max_x, max_y;
+
+	public:
+		/*
+		 Creates a minimap with every tile set to color
+		 @param width: the width of the map in tiles
+		 @param height: the height of the map in tiles
+		 @param color: in the same format as the Renderer's colors
+		 */
+		Minimap(int width, int height, unsigned int color = 0);
+
+		/*
+		 Deletes the minimap's texture from OpenGL
+		 */
+		~Minimap();
+
+		/*
+		 Sets the color of a tile
+		 Tiles outside of the map are ignored
+		 */
+		void setTile(int x, int y, unsigned int color);
+
+		/*
+		 Returns the color of a tile
+		 Tiles outside of the map are 0
+		 */
+		inline unsigned int getTile(int x, int y) const {
+			if (x < 0 || y < 0 || x >= width || y >= height)
+				return 0;
+			return colors[y * width + x];
+		}
+
+		/*
+		 Sends the tiles that changed to OpenGL
+		 with one glTexSubImage2D
+		 Does nothing if no tiles changed
+		 */
+		void upload();
+
+		/*
+		 Returns the texture to draw the minimap with
+		 The first row of tiles is the bottom of the texture,
+		 so tile y goes up the screen like positions do
+		 */
+		inline const Texture* getTexture() const {
+			return texture;
+		}
+
+		inline const int getWidth() const {
+			return width;
+		}
+
+		inline const int getHeight() const {
+			return height;
+		}
+	};
+}
+
+#endif // hi :)
\ No newline at end of file
@@ -1,43 +1,129 @@
 #include "batchrenderer.hpp"
 #include <cstddef>
 #include <assert.h>
+#include "../../util/profiler.hpp"
 
 namespace kdr {
 
-	BatchRenderer::BatchRenderer(TileData tile_info)
-	: Renderer(tile_info) {
-		// reserve this vector by how many slots are allowed to be bound to OpenGL
-		// allows push_back to not have to copy the vector over and over
-		shader_tex_ids.reserve(RENDERER_MAX_TEXTURES);
+	/*
+	 Builds an IndexBuffer that draws sprites amount of squares
+	 T is the index type, GLushort or GLuint
+	 */
+	template<typename T>
+	static IndexBuffer* createQuadIndices(const GLsizei sprites) {
+		// we need to set our IBO to all the correct indices
+		// 2 triangles is 6 vertices, but since we're drawing
+		// squares in our BatchRenderer, two triangles have 2
+		// redundant vertices, so we're setting our IBO
+		// to have 4 vertices per Square rather than 6
 
-		// generate 1 vertex array
-		glGenVertexArrays(1, &vao);
-		// generate 1 vbo
-		glGenBuffers(1, &vbo);
+		// the indices live on the heap since a full
+		// batch is far too big for the stack
+		const GLsizei indices_size = sprites * RENDERER_INDEX_COUNT;
+		std::vector<T> indices(indices_size);
 
-		// bind the vertex array and VBO to allow the following
-		// shitstorm of macros to effect the VAO and VBO
-		glBindVertexArray(vao);
-		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+		// offset starts at 0 and is incremented by 4 for each
+		// 6 vertices we set
+		T offset = 0;
 
-		// tell OpenGL the details of our buffer data (VertexData*)
-		// it's an array
-		// it's the size of RENDERER_BUFFER_SIZE
-		// the data is currently 0 (NULL)
-		// the buffer is going to be changing so it's
-		// going to be a dynamic draw
-		glBufferData(GL_ARRAY_BUFFER, RENDERER_BUFFER_SIZE, NULL, GL_DYNAMIC_DRAW);
-
-		// tell OpenGL that:
-		// our vertices are at index      0 (SHADER_VERTEX_INDEX)
-		// our UVs are at index           1 (SHADER_UV_INDEX    )
-		// our texture IDs are at index   2 (SHADER_TID_INDEX   )
-		// our colors are at index        3 (SHADER_COLOR_INDEX )
-		glEnableVertexAttribArray(SHADER_VERTEX_INDEX);
-		glEnableVertexAttribArray(SHADER_UV_INDEX);
-		glEnableVertexAttribArray(SHADER_TID_INDEX);
-		glEnableVertexAttribArray(SHADER_COLOR_INDEX);
+		// i += 6 is done so that we're setting each vertices for
+		// 2 triangles, which is 6, but we're setting the values
+		// of 2 of them equal to eachother, so that we effictively
+		// have 4 indices per square (2 triangles)
+		for (GLsizei i = 0; i < indices_size; i += RENDERER_INDEX_COUNT) {
+
+			//   0   1   2
+			//   | \     |
+			//   |   \   |
+			//   |     \ |
+			//   2   3   0
+			//   
+			//   2 redundant vertices
+			//   see from this nice graph
+			//   I made? :)
+
+			indices[  i  ] = offset + 0;
+			indices[i + 1] = offset + 1;
+			indices[i + 2] = offset + 2;
+
+			indices[i + 3] = offset + 2;
+			indices[i + 4] = offset + 3;
+			indices[i + 5] = offset + 0;
+
+			offset += RENDERER_SPRITE_VERTICES;
+		}
+
+		// now make our IBO from the indices we just
+		// made with the amount of indices in our indices
+		return new IndexBuffer(indices.data(), indices_size);
+	}
+
+	/*
+	 The quad IndexBuffers shared by every BatchRenderer
+	 Slot 0 holds 16-bit indices, slot 1 holds 32-bit indices
+	 */
+	static IndexBuffer* quad_indices[2] = { nullptr, nullptr };
+
+	/*
+	 The vertex array shared by every BatchRenderer
+	 Each renderer points it at its own VBO when flushing
+	 */
+	static GLuint batch_vao = NULL;
+
+	IndexBuffer* KDR_GetQuadIndices(const GLsizei sprites, const bool large_indices) {
+		IndexBuffer*& indices = quad_indices[large_indices];
+		// the pattern is the same for every renderer, so it's only
+		// rebuilt when a renderer needs more sprites than it holds
+		if (indices == nullptr || indices->getCount() < (GLuint)(sprites * RENDERER_INDEX_COUNT)) {
+			delete indices;
+			// 16-bit indices are always built to their full
+			// size so they only ever get built once
+			indices = large_indices ? createQuadIndices<GLuint>(sprites)
+			                        : createQuadIndices<GLushort>(RENDERER_MAX_SPRITES);
+		}
+		return indices;
+	}
+
+	void KDR_CleanRendererData() {
+		delete quad_indices[0];
+		delete quad_indices[1];
+		quad_indices[0] = nullptr;
+		quad_indices[1] = nullptr;
+		if (batch_vao != NULL)
+			glDeleteVertexArrays(1, &batch_vao);
+		batch_vao = NULL;
+		return;
+	}
+
+	/*
+	 Binds the shared vertex array, creating it
+	 the first time it's needed
+	 */
+	static void bindVertexArray() {
+		if (batch_vao == NULL) {
+			// generate 1 vertex array
+			glGenVertexArrays(1, &batch_vao);
+			glBindVertexArray(batch_vao);
+
+			// tell OpenGL that:
+			// our vertices are at index      0 (SHADER_VERTEX_INDEX)
+			// our UVs are at index           1 (SHADER_UV_INDEX    )
+			// our texture IDs are at index   2 (SHADER_TID_INDEX   )
+			// our colors are at index        3 (SHADER_COLOR_INDEX )
+			glEnableVertexAttribArray(SHADER_VERTEX_INDEX);
+			glEnableVertexAttribArray(SHADER_UV_INDEX);
+			glEnableVertexAttribArray(SHADER_TID_INDEX);
+			glEnableVertexAttribArray(SHADER_COLOR_INDEX);
+			return;
+		}
+		glBindVertexArray(batch_vao);
+		return;
+	}
 
+	/*
+	 Points the bound vertex array at the bound VBO
+	 */
+	static void setVertexLayout() {
 		// now that we've enabled these variables and told OpenGL where to look for them
 		// in the shader
 		// we tell OpenGL what this data means
@@ -72,261 +158,113 @@ namespace kdr {
 		// contained in VertexData (sizeof(VertexData))
 		// with an offset of where our color is stored in VertexData
 		glVertexAttribPointer(SHADER_COLOR_INDEX, 4, GL_UNSIGNED_BYTE, GL_TRUE, VERTEXDATA_SIZE, (const GLvoid*)(offsetof(VertexData, VertexData::color)));
+		return;
+	}
 
-		// now that we've given all the information we've needed
-		// to give, we can unbind it
-		glBindBuffer(GL_ARRAY_BUFFER, NULL);
-
-		// we need to set our IBO to all the correct indices
-		// 2 triangles is 6 vertices, but since we're drawing
-		// squares in our BatchRenderer, two triangles have 2
-		// redundant vertices, so we're setting our IBO
-		// to have 4 vertices per Square rather than 6
-
-		GLushort indices[RENDERER_INDICES_SIZE];
-
-		// offset starts at 0 and is incremented by 4 for each
-		// 6 vertices we set
-		int offset = 0;
-
-		// i += 6 is done so that we're setting each vertices for
-		// 2 triangles, which is 6, but we're setting the values
-		// of 2 of them equal to eachother, so that we effictively
-		// have 4 indices per square (2 triangles)
-		for (int i = 0; i < RENDERER_INDICES_SIZE; i += RENDERER_INDEX_COUNT) {
-
-			//   0   1   2
-			//   | \     |
-			//   |   \   |
-			//   |     \ |
-			//   2   3   0
-			//   
-			//   2 redundant vertices
-			//   see from this nice graph
-			//   I made? :)
-
-			indices[  i  ] = offset + 0;
-			indices[i + 1] = offset + 1;
-			indices[i + 2] = offset + 2;
+	BatchRenderer::BatchRenderer(TileData tile_info, GLsizei max_sprites, bool large_indices)
+	: Renderer(tile_info), max_sprites(max_sprites), large_indices(large_indices), head(0), sprite_count(0), segment_start(0), variants(nullptr), variant_features(0), target(nullptr) {
+		// a single segment can't index past the end of our IBO
+		// 32-bit indices can index the whole VBO
+		if (large_indices || max_sprites < RENDERER_MAX_SPRITES)
+			segment_sprites = max_sprites;
+		else
+			segment_sprites = RENDERER_MAX_SPRITES;
 
-			indices[i + 3] = offset + 2;
-			indices[i + 4] = offset + 3;
-			indices[i + 5] = offset + 0;
+		// reserve this vector by how many slots are allowed to be bound to OpenGL
+		// allows push_back to not have to copy the vector over and over
+		shader_tex_ids.reserve(RENDERER_MAX_TEXTURES);
 
-			offset += 4;
-		}
+		// generate 1 vbo
+		// the vertex array and IBO are shared between
+		// every BatchRenderer so this is the only
+		// thing we need to make
+		glGenBuffers(1, &vbo);
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
 
-		// now set our IBO to our indices we just
-		// made with the amount of indices in our indices
-		ibo = new IndexBuffer(indices, RENDERER_INDICES_SIZE);
+		// tell OpenGL the details of our buffer data (VertexData*)
+		// it's an array
+		// it's big enough to hold max_sprites sprites
+		// the data is currently 0 (NULL)
+		// the buffer is going to be changing so it's
+		// going to be a dynamic draw
+		glBufferData(GL_ARRAY_BUFFER, max_sprites * RENDERER_SPRITE_SIZE, NULL, GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, NULL);
 
-		// now that we've done all we need to do with our
-		// vertex array, unbind it from OpenGL
-		glBindVertexArray(NULL);
+		// make sure the shared IBO is big enough for us
+		KDR_GetQuadIndices(segment_sprites, large_indices);
 		return;
 	}
 
 	BatchRenderer::~BatchRenderer() {
-		// delete our IBO since it's a pointer
-		delete ibo;
 		// since we're getting rid of our
 		// BatchRenderer, we need to also
 		// unbind our VBO from OpenGL
 		glDeleteBuffers(1, &vbo);
-		glDeleteVertexArrays(1, &vao);
 		return;
 	}
 
 	void BatchRenderer::begin() {
+		KDR_PROFILE_ZONE("BatchRenderer::begin");
+		stats.reset();
+		// if the last frame filled the ring
+		// start over from the beginning
+		if (head >= max_sprites)
+			head = 0;
+		sprite_count = 0;
+		segment_start = head;
+		map();
+		return;
+	}
+
+	void BatchRenderer::map() {
 		// bind the VBO to OpenGL with the
 		// data we fed through to OpenGL
 		// when creating the BatchRenderer
 		glBindBuffer(GL_ARRAY_BUFFER, vbo);
-		// begin mapping the buffer as an array buffer
-		// since OpenGL doesn't need to read this memory
-		// at all, set it to write only so it can optimize
-		// this code slightly
-		buffer = (VertexData*)glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
-		return;
-	}
 
-	void BatchRenderer::draw(const Texture* texture, const int x, const int y, const unsigned int color) {
-		// we are submitting 6 vertices (4 being renderered)
-		// so we put in RENDERER_INDEX_COUNT (6)
-		flushIfNeeded(RENDERER_INDEX_COUNT);
-		const int pos_x = (x * tiles.tile_size) + (tiles.offset_x * tiles.tile_size);
-		const int pos_y = (y * tiles.tile_size) + (tiles.offset_y * tiles.tile_size);
-		const unsigned int& slot = getSlot(texture->getID());
-
-		// fill the buffers with the appropriate positions, texture slots, and colors
-		fillBuffer(*transforms_back * vec3(pos_x, pos_y, 0), uv[0], slot, color);
-		fillBuffer(*transforms_back * vec3(pos_x, pos_y + tiles.tile_size, 0), uv[1], slot, color);
-		fillBuffer(*transforms_back * vec3(pos_x + tiles.tile_size, pos_y + tiles.tile_size, 0), uv[2], slot, color);
-		fillBuffer(*transforms_back * vec3(pos_x + tiles.tile_size, pos_y, 0), uv[3], slot, color);
-		index_count += RENDERER_INDEX_COUNT;
-
-		return;
-	}
-
-	void BatchRenderer::draw(const unsigned int color, const int x, const int y) {
-		// we are submitting 6 vertices (4 being renderered)
-		// so we put in RENDERER_INDEX_COUNT (6)
-		flushIfNeeded(RENDERER_INDEX_COUNT);
-		const int pos_x = (x * tiles.tile_size) + (tiles.offset_x * tiles.tile_size);
-		const int pos_y = (y * tiles.tile_size) + (tiles.offset_y * tiles.tile_size);
-		const unsigned int& slot = getSlot(0.0f);
-
-		// fill the buffers with the appropriate positions, texture slots, and colors
-		fillBuffer(*transforms_back * vec3(pos_x, pos_y, 0), uv[0], slot, color);
-		fillBuffer(*transforms_back * vec3(pos_x, pos_y + tiles.tile_size, 0), uv[1], slot, color);
-		fillBuffer(*transforms_back * vec3(pos_x + tiles.tile_size, pos_y + tiles.tile_size, 0), uv[2], slot, color);
-		fillBuffer(*transforms_back * vec3(pos_x + tiles.tile_size, pos_y, 0), uv[3], slot, color);
-		// push our index_count by the technically correct
-		// amount of vertices our squares take up (6)
-		index_count += RENDERER_INDEX_COUNT;
-		return;
-	}
-
-	void BatchRenderer::draw(const Texture* texture, const vec3& position, const vec2& scale, const unsigned int color) {
-		// we are submitting 6 vertices (4 being renderered)
-		// so we put in RENDERER_INDEX_COUNT (6)
-		flushIfNeeded(RENDERER_INDEX_COUNT);
-
-		const float size_x = texture->getWidth() * scale.x;
-		const float size_y = texture->getHeight() * scale.y;
-
-		// get the slot of the texture's ID
-		float slot = getSlot(texture->getID());
-		// fill the buffers with the appropriate positions, texture slots, and colors
-		fillBuffer(*transforms_back * position, uv[0], slot, color);
-		fillBuffer(*transforms_back * vec3(position.x, position.y + size_y, position.z), uv[1], slot, color);
-		fillBuffer(*transforms_back * vec3(position.x + size_x, position.y + size_y, position.z), uv[2], slot, color);
-		fillBuffer(*transforms_back * vec3(position.x + size_x, position.y, position.z), uv[3], slot, color);
-		// push our index_count by the technically correct
-		// amount of vertices our squares take up (6)
-		index_count += RENDERER_INDEX_COUNT;
+		// everything past head hasn't been written since
+		// the buffer was last orphaned, so the GPU can't
+		// be reading it and we don't need to synchronize
+		// when we're starting over at 0, orphan the whole
+		// buffer so OpenGL can hand us fresh memory
+		// instead of waiting on the draws still using it
+		GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+		access |= (head == 0) ? GL_MAP_INVALIDATE_BUFFER_BIT : GL_MAP_INVALIDATE_RANGE_BIT;
+
+		buffer = (VertexData*)glMapBufferRange(GL_ARRAY_BUFFER, head * RENDERER_SPRITE_SIZE,
+			(max_sprites - head) * RENDERER_SPRITE_SIZE, access);
 		return;
 	}
 
-	void BatchRenderer::draw(const Texture* texture, const Rectangle& rect, const unsigned int color) {
-		flushIfNeeded(RENDERER_INDEX_COUNT);
+	void BatchRenderer::submitQuad(const vec3* corners, const vec2* uvs, const Texture* texture, const unsigned int color) {
+		// we are submitting 1 sprite
+		flushIfNeeded(1);
 
 		// get the slot of the texture's ID
-		float slot = getSlot(texture->getID());
-
+		const float slot = texture != nullptr ? getSlot(texture->getID()) : 0.0f;
 		// fill the buffers with the appropriate positions, texture slots, and colors
-		fillBuffer(*transforms_back * vec3(rect.x, rect.y, 0), uv[0], slot, color);
-		fillBuffer(*transforms_back * vec3(rect.x, rect.y + rect.height, 0), uv[1], slot, color);
-		fillBuffer(*transforms_back * vec3(rect.x + rect.width, rect.y + rect.height, 0), uv[2], slot, color);
-		fillBuffer(*transforms_back * vec3(rect.x + rect.width, rect.y, 0), uv[3], slot, color);
-		// push our index_count by the technically correct
-		// amount of vertices our squares take up (6)
-		index_count += RENDERER_INDEX_COUNT;
+		fillQuad(corners, uvs, slot, color);
 		return;
 	}
 
-	void BatchRenderer::drawString(const char* text, const Font& font, const int x, const int y, const unsigned int color) {
-		using namespace ftgl;
-		int text_len = strlen(text);
-		int pos_x = (x * tiles.tile_size) + (tiles.offset_x * tiles.tile_size);
-		const int pos_y = (y * tiles.tile_size) + (tiles.offset_y * tiles.tile_size);
-
-		flushIfNeeded(RENDERER_INDEX_COUNT * text_len);
+	void BatchRenderer::submitGlyph(const vec3* corners, const vec2* uvs, const Font& font, const unsigned int color) {
+		// each glyph makes its own room so a string can
+		// be longer than the ring or a segment
+		flushIfNeeded(1);
 
 		// get the texture slot of the font
 		// as text is technically an atlas
 		// which is a texture
-		float slot = getSlot(font.getID());
-		texture_font_t* ftFont = font.getFTFont();
-		for (int i = 0; i < text_len; i++) {
-			char c = text[i];
-			texture_glyph_t* glyph = texture_font_get_glyph(ftFont, c);
-			// if the glyph is a valid glyph
-			if (glyph) {
-				// we don't want to offset the first character
-				// as that would mess up the positioning of the text
-				if (i > 0) {
-					// offset the x position by the kerning of the glyph
-					float kerning = texture_glyph_get_kerning(glyph, text[i - 1]);
-					pos_x += kerning;
-				}
-
-				float x0 = pos_x + glyph->offset_x;
-				float y0 = pos_y + glyph->offset_y;
-				float x1 = x0 + glyph->width;
-				float y1 = y0 - glyph->height;
-				// NOTE:
-				// u0/1 = s0/1
-				// v0/1 = t0/1
-
-				// fill the buffer with the appropriate positions, texture slots, and colors
-				fillBuffer(*transforms_back * vec3(x0, y0, 0), vec2(glyph->s0, glyph->t0), slot, color);
-				fillBuffer(*transforms_back * vec3(x0, y1, 0), vec2(glyph->s0, glyph->t1), slot, color);
-				fillBuffer(*transforms_back * vec3(x1, y1, 0), vec2(glyph->s1, glyph->t1), slot, color);
-				fillBuffer(*transforms_back * vec3(x1, y0, 0), vec2(glyph->s1, glyph->t0), slot, color);
-
-				// push our index_count by the technically correct
-				// amount of vertices our squares take up (6)
-				index_count += RENDERER_INDEX_COUNT;
-				// add to the offset of the text
-				pos_x += glyph->advance_x;
-			}
-		}
-
-		return;
-	}
-
-	void BatchRenderer::drawString(const char* text, const Font& font, const vec3& position, const unsigned int color) {
-		using namespace ftgl;
-		int text_len = strlen(text);
-
-		flushIfNeeded(RENDERER_INDEX_COUNT * text_len);
-		// get the texture slot of the font
-		// as text is technically an atlas
-		// which is a texture
-		float ts = getSlot(font.getID());
-		float x = position.x;
-
-		texture_font_t* ftFont = font.getFTFont();
-
-		for (int i = 0; i < text_len; i++) {
-			char c = text[i];
-			texture_glyph_t* glyph = texture_font_get_glyph(ftFont, c);
-			// if the glyph is a valid glyph
-			if (glyph != NULL) {
-				// we don't want to offset the first character
-				// as that would mess up the positioning of the text
-				if (i > 0) {
-					// offset the x position by the kerning of the glyph
-					float kerning = texture_glyph_get_kerning(glyph, text[i - 1]);
-					x += kerning;
-				}
-
-				float x0 = x + glyph->offset_x;
-				float y0 = position.y + glyph->offset_y;
-				float x1 = x0 + glyph->width;
-				float y1 = y0 - glyph->height;
-				// NOTE:
-				// u0/1 = s0/1
-				// v0/1 = t0/1
-
-				// fill the buffer with the appropriate positions, texture slots, and colors
-				fillBuffer(*transforms_back * vec3(x0, y0, 0), vec2(glyph->s0, glyph->t0), ts, color);
-				fillBuffer(*transforms_back * vec3(x0, y1, 0), vec2(glyph->s0, glyph->t1), ts, color);
-				fillBuffer(*transforms_back * vec3(x1, y1, 0), vec2(glyph->s1, glyph->t1), ts, color);
-				fillBuffer(*transforms_back * vec3(x1, y0, 0), vec2(glyph->s1, glyph->t0), ts, color);
-				// push our index_count by the technically correct
-				// amount of vertices our squares take up (6)
-				index_count += RENDERER_INDEX_COUNT;
-				// add to the offset of the text
-				x += glyph->advance_x;
-			}
-		}
-
+		const float slot = getSlot(font.getID());
+		fillQuad(corners, uvs, slot, color);
 		return;
 	}
 
 	void BatchRenderer::end() {
+		KDR_PROFILE_ZONE("BatchRenderer::end");
+		// the last segment ends where we stopped writing
+		closeSegment();
+		stats.bytes_uploaded += sprite_count * RENDERER_SPRITE_SIZE;
 		// unmap the buffer from OpenGL
 		// to allow drawing
 		glUnmapBuffer(GL_ARRAY_BUFFER);
@@ -337,35 +275,115 @@ namespace kdr {
 	}
 
 	void BatchRenderer::flush() {
-		// bind every currently submitted texture
-		for (int i = 0; i < shader_tex_ids.size(); ++i) {
-			// since GL_TEXTURE<number> is sequencial
-			// we can add i to the texture slots to properly bind them
-
-			// first activate the texture
-			glActiveTexture(GL_TEXTURE0 + i);
-			// then set the texture equal to the texture ID
-			glBindTexture(GL_TEXTURE_2D, shader_tex_ids[i]);
-		}
-
-		// bind our vertex array and IBO
-		glBindVertexArray(vao);
+		KDR_PROFILE_ZONE("BatchRenderer::flush");
+		KDR_PROFILE_GPU_ZONE("BatchRenderer::flush");
+		KDR_PROFILE_COUNT(ProfileCounter::Flushes, 1);
+		++stats.flushes;
+		// bind the shared vertex array, point it
+		// at our VBO and bind the shared IBO
+		bindVertexArray();
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+		setVertexLayout();
+		glBindBuffer(GL_ARRAY_BUFFER, NULL);
+		IndexBuffer* ibo = KDR_GetQuadIndices(segment_sprites, large_indices);
 		ibo->bind();
+		if (target != nullptr)
+			target->bind();
+
+		// variants change the program, so put the
+		// caller's back once the segments are drawn
+		GLint previous_program = 0;
+		if (variants != nullptr)
+			glGetIntegerv(GL_CURRENT_PROGRAM, &previous_program);
+
+		GLuint bound_program = NULL;
+		for (const BatchSegment& segment : segments) {
+			// only switch programs when the segment
+			// needs a different variant than the last one
+			if (variants != nullptr) {
+				const unsigned int features = segment.tex_count > 0 ? variant_features : variant_features & ~SHADER_FEATURE_TEXTURED;
+				const Shader* shader = variants->get(features);
+				if (shader->getID() != bound_program) {
+					shader->bind();
+					bound_program = shader->getID();
+				}
+			}
+
+			// bind every texture the segment uses
+			for (unsigned int i = 0; i < segment.tex_count; ++i) {
+				// since GL_TEXTURE<number> is sequencial
+				// we can add i to the texture slots to properly bind them
+
+				// first activate the texture
+				glActiveTexture(GL_TEXTURE0 + i);
+				// then set the texture equal to the texture ID
+				glBindTexture(GL_TEXTURE_2D, segment_tex_ids[segment.tex_begin + i]);
+			}
+			stats.texture_binds += segment.tex_count;
+			++stats.draw_calls;
+			KDR_PROFILE_COUNT(ProfileCounter::TextureBinds, segment.tex_count);
+			KDR_PROFILE_COUNT(ProfileCounter::DrawCalls, 1);
+			KDR_PROFILE_COUNT(ProfileCounter::Vertices, segment.index_count / RENDERER_INDEX_COUNT * RENDERER_SPRITE_VERTICES);
+
+			// draw the segment's elements as triangles
+			// every segment reuses the start of the IBO
+			// and base_vertex moves the indices to where
+			// the segment lives in the VBO
+			glDrawElementsBaseVertex(GL_TRIANGLES, segment.index_count, ibo->getType(), NULL, segment.base_vertex);
+		}
 
-		// draw all of our elements
-		// as triangles
-		// with the size of index_count
-		// with type GLuint (unsigned int)
-		// we don't need to specify any indices
-		// since we've already bound our IBO
-		glDrawElements(GL_TRIANGLES, index_count, GL_UNSIGNED_SHORT, NULL);
+		if (bound_program != NULL)
+			glUseProgram(previous_program);
 
+		if (target != nullptr)
+			target->unbind();
 		// unbind our IBO once we're done drawing the elements
 		ibo->unbind();
 		// unbind our VAO from OpenGL
 		glBindVertexArray(NULL);
 
-		index_count = 0;
+		// everything we drew is used up, the next
+		// batch continues in the ring after it
+		head += sprite_count;
+		sprite_count = 0;
+		segment_start = head;
+		segments.clear();
+		segment_tex_ids.clear();
+		shader_tex_ids.clear();
+		return;
+	}
+
+	void BatchRenderer::setShaderVariants(ShaderVariants* variants, unsigned int features) {
+		this->variants = variants;
+		variant_features = features;
+		return;
+	}
+
+	void BatchRenderer::setRenderTarget(RenderTarget* target) {
+		this->target = target;
+		return;
+	}
+
+	void BatchRenderer::closeSegment() {
+		const GLsizei segment_end = head + sprite_count;
+		// nothing was drawn with the textures of an empty
+		// segment, so there's no segment to make, but the
+		// slots still have to be freed for whoever asked
+		if (segment_end == segment_start) {
+			shader_tex_ids.clear();
+			return;
+		}
+
+		BatchSegment segment;
+		segment.base_vertex = segment_start * RENDERER_SPRITE_VERTICES;
+		segment.index_count = (segment_end - segment_start) * RENDERER_INDEX_COUNT;
+		segment.tex_begin = (unsigned int)segment_tex_ids.size();
+		segment.tex_count = (unsigned int)shader_tex_ids.size();
+		segments.push_back(segment);
+
+		segment_tex_ids.insert(segment_tex_ids.end(), shader_tex_ids.begin(), shader_tex_ids.end());
+		shader_tex_ids.clear();
+		segment_start = segment_end;
 		return;
 	}
 
@@ -382,28 +400,34 @@ namespace kdr {
 		return;
 	}
 
-	void BatchRenderer::flushIfNeeded(const int expected_indices_count) {
-		// if the size of the vector is equal to or greater than
-		// our max sprite count, then we need to flush
-		if (shader_tex_ids.size() >= RENDERER_MAX_SPRITES) {
+	void BatchRenderer::fillQuad(const vec3* corners, const vec2* uvs, const float tid, const unsigned int color) {
+		fillBuffer(corners[0], uvs[0], tid, color);
+		fillBuffer(corners[1], uvs[1], tid, color);
+		fillBuffer(corners[2], uvs[2], tid, color);
+		fillBuffer(corners[3], uvs[3], tid, color);
+		++sprite_count;
+		++stats.quads_submitted;
+		return;
+	}
+
+	void BatchRenderer::flushIfNeeded(const int expected_sprites) {
+		// if the ring doesn't have room left, draw everything
+		// pending and start writing from the beginning again
+		if (head + sprite_count + expected_sprites > max_sprites) {
+			++stats.buffer_flushes;
 			end();
 			flush();
-			begin();
-			// we'll need to clear it so new textures can
-			// be used
-			shader_tex_ids.clear();
-			// we're reserving so that it's faster
-			// to push_back
-			shader_tex_ids.reserve(RENDERER_MAX_TEXTURES);
+			head = 0;
+			segment_start = 0;
+			map();
 		}
 
-		// or if our index_count is too high, we also will need to flush
-		else if (index_count + expected_indices_count >= RENDERER_MAX_SPRITES) {
-			end();
-			flush();
-			begin();
-			// we don't need to reserve or clear our vector
-			// since it wasn't the slots that forced a flush
+		// or if the current segment can't index any more sprites
+		// we only need to start a new segment, the data stays
+		// mapped and gets drawn on the next flush
+		else if (head + sprite_count - segment_start + expected_sprites > segment_sprites) {
+			++stats.index_splits;
+			closeSegment();
 		}
 		return;
 	}
@@ -420,6 +444,12 @@ namespace kdr {
 		// it sets our slot to the correct texture slot
 		// anyways
 		if (!getFound(texture_id, slot)) {
+			// if every slot is taken, the following sprites
+			// go into a new segment with its own textures
+			if (shader_tex_ids.size() >= RENDERER_MAX_TEXTURES) {
+				++stats.texture_splits;
+				closeSegment();
+			}
 			// push back our texture ID
 			shader_tex_ids.push_back(texture_id);
 			// make the slot equal to the back of the vector
@@ -438,6 +468,10 @@ namespace kdr {
 		// it sets our slot to the correct texture slot
 		// anyways
 		if (!getFound(texture_id, slot)) {
+			if (shader_tex_ids.size() >= RENDERER_MAX_TEXTURES) {
+				++stats.texture_splits;
+				closeSegment();
+			}
 			// push back our texture ID
 			shader_tex_ids.push_back(texture_id);
 			// make the slot equal to the back of the vector
@@ -4,6 +4,8 @@
 #include "renderer.hpp"
 #include "indexbuffer.hpp"
 #include "vertexdata.hpp"
+#include "../shadervariant.hpp"
+#include "../rendertarget.hpp"
 
 /*
 The amount of indices in a sprite
@@ -12,11 +14,17 @@ The amount of indices in a sprite
 
 /*
  The maximum amount of sprites
- allowed to be submitted before
- being forced to flush
+ a single draw call (segment) can hold
+ Also the default capacity of a BatchRenderer
+ 16-bit indices can reach at most 16384 sprites
  */
 #define RENDERER_MAX_SPRITES (16002)
 
+/*
+ The amount of vertices in a sprite
+ */
+#define RENDERER_SPRITE_VERTICES (4)
+
 /*
  The size of a sprite as
  4 VertexDatas
@@ -25,12 +33,12 @@ The amount of indices in a sprite
 
 /*
  The size of the buffer data to be submitted
- to OpenGL
+ to OpenGL with the default capacity
  */
 #define RENDERER_BUFFER_SIZE (RENDERER_SPRITE_SIZE * RENDERER_MAX_SPRITES)
 
 /*
- The amount of indices in the buffer
+ The amount of indices in a 16-bit buffer
  Although we're using IndexBuffer to only draw
  4 indices per sprite, there's still 6 indices in a square
  since it's drawn as 2 triangles
@@ -63,16 +71,29 @@ The amount of indices in a sprite
 #define SHADER_COLOR_INDEX	    3
 
 namespace kdr {
-	class BatchRenderer : public Renderer {
-	private:
+	/*
+	 A run of sprites in the VBO that share
+	 the same texture slots and can be drawn
+	 with a single glDrawElementsBaseVertex
+	 */
+	struct BatchSegment {
+		/*
+		 The first vertex of the segment in the VBO
+		 */
+		GLint base_vertex;
+		/*
+		 The amount of indices to draw
+		 */
+		GLsizei index_count;
 		/*
-		 Vertex array object
-		 Stores memory about our
-		 completed objects
-		 (ID, vertices ect...)
+		 Where the segment's textures start
+		 in segment_tex_ids and how many there are
 		 */
-		GLuint vao;
+		unsigned int tex_begin, tex_count;
+	};
 
+	class BatchRenderer : public Renderer {
+	private:
 		/*
 		 Vertex buffer object
 		 Holds memory about our vertices
@@ -80,21 +101,54 @@ namespace kdr {
 		GLuint vbo;
 
 		/*
-		 Since we draw triangles
-		 we can reduce how many indices
-		 have to be drawn by sharing
-		 the same indices with the triangles
-		 Lowers the amount of vertices
-		 that need to be accounted for
-		 and stored
+		 The amount of sprites the VBO can hold
+		 The VBO is used as a ring, when the end
+		 is reached the pending segments are drawn
+		 and writing starts over from the beginning
 		 */
-		IndexBuffer* ibo;
+		GLsizei max_sprites;
 
 		/*
-		 The amount of indices our
-		 BatchRenderer is holding
+		 Whether the shared 32-bit quad indices
+		 are used instead of the 16-bit ones
 		 */
-		GLsizei index_count;
+		bool large_indices;
+
+		/*
+		 The amount of sprites a single segment can hold
+		 Capped by the size of the IBO
+		 */
+		GLsizei segment_sprites;
+
+		/*
+		 The sprite in the VBO where the
+		 currently mapped range starts
+		 */
+		GLsizei head;
+
+		/*
+		 The amount of sprites written
+		 since head
+		 */
+		GLsizei sprite_count;
+
+		/*
+		 The sprite in the VBO where the
+		 current segment starts
+		 */
+		GLsizei segment_start;
+
+		/*
+		 Segments that are waiting to be drawn
+		 on the next flush
+		 */
+		std::vector<BatchSegment> segments;
+
+		/*
+		 The texture IDs of every pending segment
+		 laid out one after another
+		 */
+		std::vector<GLuint> segment_tex_ids;
 
 		/*
 		 Struct that stores
@@ -104,13 +158,29 @@ namespace kdr {
 		VertexData* buffer;
 
 		/*
-		 The textures currently bound
-		 to our BatchRenderer
+		 The textures used by the current segment
 		 When it reaches RENDERER_MAX_TEXTURES (31)
-		 it flushes all the current submitted data
+		 a new segment is started
 		 */
 		std::vector<GLuint> shader_tex_ids;
 
+		/*
+		 The programs flush picks from per segment
+		 nullptr to draw with whatever shader is bound
+		 */
+		ShaderVariants* variants;
+		/*
+		 The features every segment is drawn with
+		 Segments without textures drop SHADER_FEATURE_TEXTURED
+		 */
+		unsigned int variant_features;
+
+		/*
+		 Where flush draws to
+		 nullptr for the bound framebuffer
+		 */
+		RenderTarget* target;
+
 		/*
 		 Fills our buffer (VertexData*) with the required
 		 information and then increments the pointer
@@ -119,13 +189,34 @@ namespace kdr {
 		void fillBuffer(const vec3& vertex, const vec2& uv, const float tid, const unsigned int color);
 
 		/*
-		 If the BatchRenderer needs to be flushed, it
-		 flushes all the data stored so far
-		 @param expected_indices_count: the amount of
-		 indices the submitted data will yield
-		 Text will be 6 indices per glyph
+		 Fills our buffer with the 4 corners of a square
+		 and counts it as a submitted sprite
+		 */
+		void fillQuad(const vec3* corners, const vec2* uvs, const float tid, const unsigned int color);
+
+		/*
+		 Makes room for the submitted sprites
+		 Starts a new segment if the current one is full
+		 and wraps the ring (drawing everything pending)
+		 if the VBO is full
+		 @param expected_sprites: the amount of
+		 sprites the submitted data will yield
+		 Can't be more than max_sprites or segment_sprites
 		 */
-		void flushIfNeeded(const int expected_indices_count);
+		void flushIfNeeded(const int expected_sprites);
+
+		/*
+		 Closes the current segment so the following sprites
+		 start a new one with an empty set of textures
+		 Nothing is unmapped or drawn
+		 */
+		void closeSegment();
+
+		/*
+		 Maps the VBO from head to the end of the buffer
+		 Orphans the buffer when starting over at 0
+		 */
+		void map();
 
 		/*
 		 Returns the texture slot index in our shader_tex_ids
@@ -147,12 +238,27 @@ namespace kdr {
 		 */
 		bool getFound(const float texture_id, float& slot);
 
+	protected:
+		/*
+		 Writes a square into the mapped VBO
+		 */
+		void submitQuad(const vec3* corners, const vec2* uvs, const Texture* texture, const unsigned int color) override;
+
+		/*
+		 Writes a glyph into the mapped VBO
+		 */
+		void submitGlyph(const vec3* corners, const vec2* uvs, const Font& font, const unsigned int color) override;
+
 	public:
 		/*
 		 An efficient renderer that batches textures
 		 and vertices together
+		 @param max_sprites: the amount of sprites the
+		 VBO can hold before it wraps around
+		 @param large_indices: use 32-bit indices so a single
+		 draw call can hold more than RENDERER_MAX_SPRITES sprites
 		 */
-		BatchRenderer(TileData tile_info);
+		BatchRenderer(TileData tile_info, GLsizei max_sprites = RENDERER_MAX_SPRITES, bool large_indices = false);
 		/*
 		 An efficient renderer that batches textures
 		 and vertices together
@@ -173,46 +279,47 @@ namespace kdr {
 		void end() override;
 
 		/*
-		 Draws a textured square to a tile according to the
-		 x and y values
-		 */
-		void draw(const Texture* texture, const int x, const int y, const unsigned int color) override;
-
-		/*
-		 Draws a colored square to a tile according to the
-		 x and y values
+		 Sends all the data to OpenGL
+		 and displays all the submitted
+		 data onto the screen
 		 */
-		void draw(const unsigned int color, const int x, const int y) override;
+		void flush() override;
 
 		/*
-		 Draws a texture to the screen without tiled restrictions
+		 Lets flush bind the cheapest variant for each segment
+		 instead of using the bound shader
+		 Segments that only have flat colors skip texturing
+		 The program bound before flush is bound again after it
+		 @param variants: nullptr to go back to the bound shader
+		 @param features: SHADER_FEATURE flags or'd together
 		 */
-		void draw(const Texture* texture, const vec3& position, const vec2& scale, const unsigned int color) override;
+		void setShaderVariants(ShaderVariants* variants, unsigned int features);
 
 		/*
-		 Draws a texture to the screen without tiled restrictions
-		 */
-		 void draw(const Texture* texture, const Rectangle& rect, const unsigned int color) override;
-		
-		/*
-		 Draws a message to the screen according to the
-		 x and y values
+		 Makes flush draw into a RenderTarget instead of the window
+		 The shader's projection should match the target,
+		 see RenderTarget::getProjection
+		 @param target: nullptr to draw to the window again
 		 */
-		void drawString(const char* text, const Font& font, const int x, const int y, const unsigned int color) override;
-		
+		void setRenderTarget(RenderTarget* target);
+	};
 
-		/*
-		 Draws a message to the screen without tile restrictions
-		 */
-		void drawString(const char* text, const Font& font, const vec3& position, const unsigned int color) override;
+	/*
+	 Gets the quad IndexBuffer shared by every BatchRenderer
+	 Since we draw triangles we can reduce how many indices
+	 have to be drawn by sharing the same indices with the triangles
+	 The buffer is built the first time it's needed and rebuilt
+	 only if more sprites are asked for than it holds
+	 @param sprites: the amount of sprites the buffer needs to draw
+	 @param large_indices: whether the buffer uses 32-bit indices
+	 */
+	IndexBuffer* KDR_GetQuadIndices(const GLsizei sprites, const bool large_indices);
 
-		/*
-		 Sends all the data to OpenGL
-		 and displays all the submitted
-		 data onto the screen
-		 */
-		void flush() override;
-	};
+	/*
+	 Deletes the IndexBuffers and vertex array
+	 shared by every BatchRenderer from OpenGL
+	 */
+	void KDR_CleanRendererData();
 }
 
 #endif // hi :)
\ No newline at end of file
@@ -2,7 +2,7 @@
 
 namespace kdr {
 	IndexBuffer::IndexBuffer(GLushort* data, GLsizei count)
-	: count(count) {
+	: count(count), type(GL_UNSIGNED_SHORT) {
 		// generates a buffer and we're going
 		// to retrieve the ID from the generation
 		// and give it to our IndexBuffer's ID
@@ -27,7 +27,7 @@ namespace kdr {
 	}
 
 	IndexBuffer::IndexBuffer(GLuint* data, GLsizei count)
-	: count(count) {
+	: count(count), type(GL_UNSIGNED_INT) {
 		// generates a buffer and we're going
 		// to retrieve the ID from the generation
 		// and give it to our IndexBuffer's ID
@@ -36,7 +36,7 @@ namespace kdr {
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer_id);
 		// our buffer is an array buffer
 		// with size of the count (amount of elements)
-		// multiplied by the size of a unsigned short
+		// multiplied by the size of a unsigned int
 
 		// since the index buffer is designed to be used over and over
 		// without changing the indices in the data
@@ -77,4 +77,8 @@ namespace kdr {
 	const GLuint IndexBuffer::getCount() const {
 		return count;
 	}
+
+	const GLenum IndexBuffer::getType() const {
+		return type;
+	}
 }
\ No newline at end of file
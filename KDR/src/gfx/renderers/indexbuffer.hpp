@@ -21,6 +21,12 @@ namespace kdr {
 		 */
 		GLuint count;
 
+		/*
+		 The OpenGL type of the indices
+		 GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+		 */
+		GLenum type;
+
 	public:
 		/*
 		 Allows the ability to reduce vertices and improve performance
@@ -62,6 +68,12 @@ namespace kdr {
 		 */
 		const GLuint getCount() const;
 
+		/*
+		 Gets the OpenGL type of the indices
+		 to pass to glDrawElements
+		 */
+		const GLenum getType() const;
+
 	};
 }
 
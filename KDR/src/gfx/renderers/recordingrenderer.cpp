@@ -0,0 +1,119 @@
+#include "recordingrenderer.hpp"
+
+namespace kdr {
+	/*
+	 Where the checksum starts
+	 */
+	static const unsigned long long CHECKSUM_BASIS = 14695981039346656037ull;
+
+	RecordingRenderer::RecordingRenderer(TileData tile_info, unsigned int reserve_sprites, int max_sprites, bool large_indices)
+	: Renderer(tile_info), checksum(CHECKSUM_BASIS), max_sprites(max_sprites), head(0), sprite_count(0), segment_start(0) {
+		// the same cap BatchRenderer puts on a segment
+		if (large_indices || max_sprites < RECORDING_MAX_SPRITES)
+			segment_sprites = max_sprites;
+		else
+			segment_sprites = RECORDING_MAX_SPRITES;
+		vertices.reserve(reserve_sprites * 4);
+		slots.reserve(RECORDING_MAX_TEXTURES);
+		return;
+	}
+
+	void RecordingRenderer::begin() {
+		stats.reset();
+		vertices.clear();
+		slots.clear();
+		checksum = CHECKSUM_BASIS;
+		if (head >= max_sprites)
+			head = 0;
+		sprite_count = 0;
+		segment_start = head;
+		return;
+	}
+
+	void RecordingRenderer::end() {
+		return;
+	}
+
+	void RecordingRenderer::flush() {
+		++stats.flushes;
+		// what BatchRenderer would have sent
+		stats.bytes_uploaded = vertices.size() * VERTEXDATA_SIZE;
+		head += sprite_count;
+		sprite_count = 0;
+		segment_start = head;
+		slots.clear();
+		return;
+	}
+
+	void RecordingRenderer::fillQuad(const vec3* corners, const vec2* uvs, const float tid, const unsigned int color) {
+		for (int i = 0; i < 4; ++i) {
+			// zero the padding, if any, so it doesn't
+			// change the checksum
+			VertexData vertex = {};
+			vertex.vertex = corners[i];
+			vertex.uv = uvs[i];
+			vertex.tid = tid;
+			vertex.color = color;
+			vertices.push_back(vertex);
+
+			const unsigned char* bytes = (const unsigned char*)&vertex;
+			for (size_t b = 0; b < sizeof(vertex); ++b) {
+				checksum ^= bytes[b];
+				checksum *= 1099511628211ull;
+			}
+		}
+		++sprite_count;
+		++stats.quads_submitted;
+		return;
+	}
+
+	void RecordingRenderer::reserveSprite() {
+		// the same checks as BatchRenderer::flushIfNeeded
+		if (head + sprite_count + 1 > max_sprites) {
+			++stats.buffer_flushes;
+			flush();
+			head = 0;
+			segment_start = 0;
+		}
+		else if (head + sprite_count - segment_start + 1 > segment_sprites) {
+			++stats.index_splits;
+			closeSegment();
+		}
+		return;
+	}
+
+	void RecordingRenderer::closeSegment() {
+		slots.clear();
+		segment_start = head + sprite_count;
+		return;
+	}
+
+	float RecordingRenderer::getSlot(const void* source) {
+		if (source == nullptr)
+			return 0.0f;
+		for (unsigned int i = 0; i < slots.size(); ++i)
+			if (slots[i] == source)
+				return (float)(i + 1);
+
+		// BatchRenderer starts a new segment
+		// with its own slots when they run out
+		if (slots.size() >= RECORDING_MAX_TEXTURES) {
+			++stats.texture_splits;
+			closeSegment();
+		}
+		slots.push_back(source);
+		return (float)slots.size();
+	}
+
+	void RecordingRenderer::submitQuad(const vec3* corners, const vec2* uvs, const Texture* texture, const unsigned int color) {
+		reserveSprite();
+		fillQuad(corners, uvs, getSlot(texture), color);
+		return;
+	}
+
+	void RecordingRenderer::submitGlyph(const vec3* corners, const vec2* uvs, const Font& font, const unsigned int color) {
+		reserveSprite();
+		fillQuad(corners, uvs, getSlot(&font), color);
+		return;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+#ifndef _KDR_RECORDINGRENDERER_HPP
+#define _KDR_RECORDINGRENDERER_HPP
+
+#include "renderer.hpp"
+#include "vertexdata.hpp"
+
+/*
+ The amount of texture slots the recorded
+ stream uses, the same as BatchRenderer
+ */
+#define RECORDING_MAX_TEXTURES (31)
+
+/*
+ The amount of sprites a BatchRenderer holds by default
+ and that a 16-bit indexed draw call can hold
+ */
+#define RECORDING_MAX_SPRITES (16002)
+
+namespace kdr {
+	/*
+	 A renderer that never touches OpenGL
+	 Writes the vertices BatchRenderer would upload into memory
+	 and keeps a checksum of them, so draw submission can be
+	 benchmarked without a GPU and geometry can be compared
+	 against a known good checksum
+	 */
+	class RecordingRenderer : public Renderer {
+	private:
+		/*
+		 Every vertex submitted since begin
+		 */
+		std::vector<VertexData> vertices;
+
+		/*
+		 The textures and fonts of the current batch in slot order
+		 Kept by address since without OpenGL every
+		 texture and atlas has the ID 0
+		 */
+		std::vector<const void*> slots;
+
+		/*
+		 64 bit FNV-1a hash of every vertex since begin
+		 */
+		unsigned long long checksum;
+
+		/*
+		 The BatchRenderer ring being mirrored, so slots
+		 are reset at the same sprites as it resets them
+		 See BatchRenderer for what each one is
+		 */
+		int max_sprites, segment_sprites;
+		int head, sprite_count, segment_start;
+
+		/*
+		 Adds a square's vertices and hashes them
+		 */
+		void fillQuad(const vec3* corners, const vec2* uvs, const float tid, const unsigned int color);
+
+		/*
+		 Starts a new segment or wraps the ring when
+		 BatchRenderer would for the next sprite
+		 */
+		void reserveSprite();
+
+		/*
+		 Ends the current segment and frees its slots
+		 */
+		void closeSegment();
+
+		/*
+		 Returns the slot of a texture or font in the
+		 same first use order BatchRenderer assigns them
+		 @param source: nullptr for a colored square
+		 */
+		float getSlot(const void* source);
+
+	protected:
+		/*
+		 Records a square
+		 */
+		void submitQuad(const vec3* corners, const vec2* uvs, const Texture* texture, const unsigned int color) override;
+
+		/*
+		 Records a glyph
+		 */
+		void submitGlyph(const vec3* corners, const vec2* uvs, const Font& font, const unsigned int color) override;
+
+	public:
+		/*
+		 A renderer that records vertices instead of drawing
+		 @param reserve_sprites: how many sprites to make room
+		 for up front so recording doesn't allocate
+		 @param max_sprites, large_indices: the same as the
+		 BatchRenderer the recording is compared against
+		 */
+		RecordingRenderer(TileData tile_info, unsigned int reserve_sprites = 0, int max_sprites = RECORDING_MAX_SPRITES, bool large_indices = false);
+
+		/*
+		 Clears the recorded vertices and checksum
+		 Keeps the memory for the next frame
+		 */
+		void begin() override;
+
+		/*
+		 Does nothing, there's nothing to unmap
+		 */
+		void end() override;
+
+		/*
+		 Counts the flush, nothing is drawn
+		 */
+		void flush() override;
+
+		/*
+		 Returns every vertex recorded since begin
+		 */
+		inline const std::vector<VertexData>& getVertices() const {
+			return vertices;
+		}
+
+		/*
+		 Returns the checksum of every vertex recorded since begin
+		 Equal checksums mean equal geometry
+		 */
+		inline unsigned long long getChecksum() const {
+			return checksum;
+		}
+	};
+}
+
+#endif // hi :)
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "renderer.hpp"
+#include <string.h>
 
 namespace kdr {
 	TileData::TileData(unsigned char tile_size, unsigned short offset_x, unsigned short offset_y)
@@ -6,6 +7,31 @@ namespace kdr {
 		return;
 	}
 
+	RenderStats::RenderStats() {
+		reset();
+		return;
+	}
+
+	void RenderStats::reset() {
+		// every member is a number so zeroing
+		// the memory is the cheapest reset
+		memset(this, 0, sizeof(RenderStats));
+		return;
+	}
+
+	bool RenderStats::exceeds(const RenderStats& budget) const {
+		return (budget.quads_submitted && quads_submitted > budget.quads_submitted)
+			|| (budget.quads_culled    && quads_culled    > budget.quads_culled)
+			|| (budget.glyph_misses    && glyph_misses    > budget.glyph_misses)
+			|| (budget.flushes         && flushes         > budget.flushes)
+			|| (budget.buffer_flushes  && buffer_flushes  > budget.buffer_flushes)
+			|| (budget.texture_splits  && texture_splits  > budget.texture_splits)
+			|| (budget.index_splits    && index_splits    > budget.index_splits)
+			|| (budget.draw_calls      && draw_calls      > budget.draw_calls)
+			|| (budget.texture_binds   && texture_binds   > budget.texture_binds)
+			|| (budget.bytes_uploaded  && bytes_uploaded  > budget.bytes_uploaded);
+	}
+
 	Renderer::Renderer(TileData tile_info)
 	: tiles(tile_info), transforms(std::vector<mat4>()) {
 		transforms.push_back(mat4::identity());
@@ -33,4 +59,127 @@ namespace kdr {
 		transforms_back = &transforms.back();
 		return;
 	}
+
+	void Renderer::setCullBounds(const Rectangle& bounds) {
+		cull_bounds = bounds;
+		return;
+	}
+
+	void Renderer::clearCullBounds() {
+		cull_bounds = Rectangle();
+		return;
+	}
+
+	bool Renderer::cull(const vec3* corners) {
+		if (cull_bounds.width <= 0.0f || cull_bounds.height <= 0.0f)
+			return false;
+
+		// find the box around the corners since
+		// transforms can rotate the square
+		float min_x = corners[0].x, max_x = corners[0].x;
+		float min_y = corners[0].y, max_y = corners[0].y;
+		for (int i = 1; i < 4; ++i) {
+			min_x = corners[i].x < min_x ? corners[i].x : min_x;
+			max_x = corners[i].x > max_x ? corners[i].x : max_x;
+			min_y = corners[i].y < min_y ? corners[i].y : min_y;
+			max_y = corners[i].y > max_y ? corners[i].y : max_y;
+		}
+
+		if (max_x < cull_bounds.x || min_x > cull_bounds.x + cull_bounds.width
+		 || max_y < cull_bounds.y || min_y > cull_bounds.y + cull_bounds.height) {
+			++stats.quads_culled;
+			return true;
+		}
+		return false;
+	}
+	vec3 Renderer::tilePosition(const int x, const int y) const {
+		return vec3((x * tiles.tile_size) + (tiles.offset_x * tiles.tile_size),
+			(y * tiles.tile_size) + (tiles.offset_y * tiles.tile_size), 0);
+	}
+
+	void Renderer::makeCorners(const vec3& position, const float width, const float height, vec3* corners) const {
+		corners[0] = *transforms_back * position;
+		corners[1] = *transforms_back * vec3(position.x, position.y + height, position.z);
+		corners[2] = *transforms_back * vec3(position.x + width, position.y + height, position.z);
+		corners[3] = *transforms_back * vec3(position.x + width, position.y, position.z);
+		return;
+	}
+
+	void Renderer::draw(const Texture* texture, const int x, const int y, const unsigned int color) {
+		vec3 corners[4];
+		makeCorners(tilePosition(x, y), tiles.tile_size, tiles.tile_size, corners);
+		if (!cull(corners))
+			submitQuad(corners, uv, texture, color);
+		return;
+	}
+
+	void Renderer::draw(const unsigned int color, const int x, const int y) {
+		vec3 corners[4];
+		makeCorners(tilePosition(x, y), tiles.tile_size, tiles.tile_size, corners);
+		if (!cull(corners))
+			submitQuad(corners, uv, nullptr, color);
+		return;
+	}
+
+	void Renderer::draw(const Texture* texture, const vec3& position, const vec2& scale, const unsigned int color) {
+		vec3 corners[4];
+		makeCorners(position, texture->getWidth() * scale.x, texture->getHeight() * scale.y, corners);
+		if (!cull(corners))
+			submitQuad(corners, uv, texture, color);
+		return;
+	}
+
+	void Renderer::draw(const Texture* texture, const Rectangle& rect, const unsigned int color) {
+		vec3 corners[4];
+		makeCorners(vec3(rect.x, rect.y, 0), rect.width, rect.height, corners);
+		if (!cull(corners))
+			submitQuad(corners, uv, texture, color);
+		return;
+	}
+
+	void Renderer::drawString(const char* text, const Font& font, const int x, const int y, const unsigned int color) {
+		// the tiled version is the same as the
+		// untiled version once it's in pixels
+		drawString(text, font, tilePosition(x, y), color);
+		return;
+	}
+
+	void Renderer::drawString(const char* text, const Font& font, const vec3& position, const unsigned int color) {
+		using namespace ftgl;
+		const int text_len = strlen(text);
+		float x = position.x;
+
+		for (int i = 0; i < text_len; i++) {
+			bool missed = false;
+			texture_glyph_t* glyph = font.getGlyph(text[i], missed);
+			if (missed)
+				++stats.glyph_misses;
+			if (glyph == NULL)
+				continue;
+
+			// we don't want to offset the first character
+			// as that would mess up the positioning of the text
+			if (i > 0)
+				x += texture_glyph_get_kerning(glyph, text[i - 1]);
+
+			// glyphs hang down from their offset
+			vec3 corners[4];
+			makeCorners(vec3(x + glyph->offset_x, position.y + glyph->offset_y, 0), (float)glyph->width, -(float)glyph->height, corners);
+			// NOTE:
+			// u0/1 = s0/1
+			// v0/1 = t0/1
+			const vec2 glyph_uv[4] = {
+				vec2(glyph->s0, glyph->t0),
+				vec2(glyph->s0, glyph->t1),
+				vec2(glyph->s1, glyph->t1),
+				vec2(glyph->s1, glyph->t0)
+			};
+
+			if (!cull(corners))
+				submitGlyph(corners, glyph_uv, font, color);
+			// add to the offset of the text
+			x += glyph->advance_x;
+		}
+		return;
+	}
 }
\ No newline at end of file
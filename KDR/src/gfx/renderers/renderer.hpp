@@ -30,14 +30,85 @@ namespace kdr {
 	};
 
 
+	/*
+	 What a Renderer did since it last began
+	 Every member is reset when begin is called
+	 */
+	struct RenderStats {
+		/*
+		 Squares written into the renderer
+		 Includes glyphs
+		 */
+		unsigned int quads_submitted;
+		/*
+		 Squares skipped because they were
+		 outside of the cull bounds
+		 */
+		unsigned int quads_culled;
+		/*
+		 Glyphs that weren't in the font's
+		 atlas and had to be loaded
+		 */
+		unsigned int glyph_misses;
+		/*
+		 Times the renderer was flushed
+		 */
+		unsigned int flushes;
+		/*
+		 Flushes forced mid-frame because the
+		 renderer ran out of buffer space
+		 */
+		unsigned int buffer_flushes;
+		/*
+		 Draw calls started because the
+		 renderer ran out of texture slots
+		 */
+		unsigned int texture_splits;
+		/*
+		 Draw calls started because a single draw
+		 call ran out of indices
+		 */
+		unsigned int index_splits;
+		/*
+		 Draw calls sent to OpenGL
+		 */
+		unsigned int draw_calls;
+		/*
+		 Textures bound to OpenGL
+		 */
+		unsigned int texture_binds;
+		/*
+		 Vertex data written for OpenGL in bytes
+		 */
+		unsigned long long bytes_uploaded;
+
+		/*
+		 Every stat starts at 0
+		 */
+		RenderStats();
+
+		/*
+		 Sets every stat back to 0
+		 */
+		void reset();
+
+		/*
+		 Returns true if any stat is higher than the
+		 same stat in budget
+		 Stats that are 0 in budget are ignored
+		 */
+		bool exceeds(const RenderStats& budget) const;
+	};
+
 	/*
 	 Base class for rendering objects to a window
 	 Includes basic functions that every renderer should need
 	 Has transform stacks that allow GUI to push in a transform
 	 Submit all the data with that pushed transform
 	 then pop it out once all the data is submitted
-	 Does not have it's own drawing functions as each renderer
-	 will handle it differently
+	 Lays out every square and glyph itself and hands them
+	 to submitQuad and submitGlyph, which each renderer
+	 handles differently
 	 */
 	class Renderer abstract {
 	protected:
@@ -68,6 +139,49 @@ namespace kdr {
 		 */
 		const TileData tiles;
 
+		/*
+		 What this renderer did since it last began
+		 */
+		RenderStats stats;
+
+		/*
+		 Squares outside of these bounds are skipped
+		 No culling is done if the width or height is 0
+		 */
+		Rectangle cull_bounds;
+
+		/*
+		 Returns true if the 4 transformed corners of a square
+		 are all outside of the cull bounds
+		 Counts the square as culled if so
+		 */
+		bool cull(const vec3* corners);
+
+		/*
+		 Returns where a tile starts in pixels
+		 */
+		vec3 tilePosition(const int x, const int y) const;
+
+		/*
+		 Transforms the 4 corners of a square in the
+		 same order as uv
+		 A negative height goes down from position like glyphs do
+		 */
+		void makeCorners(const vec3& position, const float width, const float height, vec3* corners) const;
+
+		/*
+		 Writes a square that wasn't culled
+		 Every draw ends here, so it's all a renderer has to implement
+		 @param texture: nullptr for a colored square
+		 */
+		virtual void submitQuad(const vec3* corners, const vec2* uvs, const Texture* texture, const unsigned int color) = 0;
+
+		/*
+		 Writes a glyph's square that wasn't culled
+		 @param uvs: where the glyph is in the font's atlas
+		 */
+		virtual void submitGlyph(const vec3* corners, const vec2* uvs, const Font& font, const unsigned int color) = 0;
+
 		/*
 		 Adds a matrix identity to the back of the transforms vector
 		 */
@@ -96,6 +210,25 @@ namespace kdr {
 		 */
 		void pop();
 
+		/*
+		 Returns what the renderer did since it last began
+		 */
+		inline const RenderStats& getStats() const {
+			return stats;
+		}
+
+		/*
+		 Skips any square that lands outside of bounds
+		 @param bounds: the visible area after transforms,
+		 usually the window's size
+		 */
+		void setCullBounds(const Rectangle& bounds);
+
+		/*
+		 Stops skipping squares
+		 */
+		void clearCullBounds();
+
 		/*
 		 Begins the process of submitting
 		 data to the Renderer
@@ -119,34 +252,34 @@ namespace kdr {
 		 Draws a textured square to a tile according to the
 		 x and y values
 		 */
-		virtual void draw(const Texture* texture, const int x, const int y, const unsigned int color) = 0;
+		virtual void draw(const Texture* texture, const int x, const int y, const unsigned int color);
 
 		/*
 		 Draws a colored square to a tile according to the
 		 x and y values
 		 */
-		virtual void draw(const unsigned int color, const int x, const int y) = 0;
+		virtual void draw(const unsigned int color, const int x, const int y);
 
 		/*
 		 Draws a texture to the screen without tiled restrictions
 		 */
-		virtual void draw(const Texture* texture, const vec3& position, const vec2& scale, const unsigned int color) = 0;
+		virtual void draw(const Texture* texture, const vec3& position, const vec2& scale, const unsigned int color);
 
 		/*
 		 Draws a texture to the screen without tiled restrictions
 		 */
-		virtual void draw(const Texture* texture, const Rectangle& rect, const unsigned int color) = 0;
+		virtual void draw(const Texture* texture, const Rectangle& rect, const unsigned int color);
 
 		/*
 		 Draws a message to the screen according to the
 		 x and y values
 		 */
-		virtual void drawString(const char* text, const Font& font, const int x, const int y, const unsigned int color) = 0;
+		virtual void drawString(const char* text, const Font& font, const int x, const int y, const unsigned int color);
 
 		/*
 		 Draws a message to the screen without tile restrictions
 		 */
-		virtual void drawString(const char* text, const Font& font, const vec3& position, const unsigned int color) = 0;
+		virtual void drawString(const char* text, const Font& font, const vec3& position, const unsigned int color);
 	};
 }
 
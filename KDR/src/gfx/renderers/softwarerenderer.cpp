@@ -0,0 +1,227 @@
+#include "softwarerenderer.hpp"
+#include "../../util/pngwriter.hpp"
+#include "../../util/simd.hpp"
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+namespace kdr {
+	/*
+	 x / 255 rounded, for x up to 255 * 255
+	 */
+	static inline uint32_t div255(uint32_t x) {
+		x += 128;
+		return (x + (x >> 8)) >> 8;
+	}
+
+	/*
+	 Multiplies each channel of a texel by the color
+	 like the shader does
+	 */
+	static inline uint32_t modulate(uint32_t texel, uint32_t color) {
+		uint32_t result = 0;
+		for (int shift = 0; shift < 32; shift += 8)
+			result |= div255(((texel >> shift) & 0xFF) * ((color >> shift) & 0xFF)) << shift;
+		return result;
+	}
+
+	/*
+	 Blends src over dst with
+	 glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA)
+	 */
+	static inline uint32_t blend(uint32_t dst, uint32_t src) {
+		const uint32_t alpha = src >> 24;
+		const uint32_t inverse = 255 - alpha;
+		uint32_t result = 0;
+		for (int shift = 0; shift < 32; shift += 8)
+			result |= div255(((src >> shift) & 0xFF) * alpha + ((dst >> shift) & 0xFF) * inverse) << shift;
+		return result;
+	}
+
+#ifdef KDR_SSE2
+	/*
+	 div255 for 8 16 bit lanes
+	 */
+	static inline __m128i div255x8(__m128i x) {
+		x = _mm_add_epi16(x, _mm_set1_epi16(128));
+		return _mm_mulhi_epu16(x, _mm_set1_epi16(257));
+	}
+
+	/*
+	 blend for 2 pixels unpacked to 16 bits a channel
+	 */
+	static inline __m128i blendx2(__m128i dst, __m128i src) {
+		const __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(src, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+		const __m128i inverse = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+		return div255x8(_mm_add_epi16(_mm_mullo_epi16(src, alpha), _mm_mullo_epi16(dst, inverse)));
+	}
+#endif
+
+	/*
+	 Modulates texels by color and blends them over dst
+	 */
+	static void blendSpan(uint32_t* dst, const uint32_t* src, int count, uint32_t color) {
+		int i = 0;
+#ifdef KDR_SSE2
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i tint = _mm_unpacklo_epi8(_mm_set1_epi32((int)color), zero);
+		for (; i + 4 <= count; i += 4) {
+			const __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+			const __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+			const __m128i s_low  = div255x8(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), tint));
+			const __m128i s_high = div255x8(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), tint));
+			const __m128i low  = blendx2(_mm_unpacklo_epi8(d, zero), s_low);
+			const __m128i high = blendx2(_mm_unpackhi_epi8(d, zero), s_high);
+			_mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(low, high));
+		}
+#endif
+		for (; i < count; ++i)
+			dst[i] = blend(dst[i], modulate(src[i], color));
+		return;
+	}
+
+	/*
+	 Blends a single color over dst
+	 */
+	static void blendColor(uint32_t* dst, int count, uint32_t color) {
+		const uint32_t alpha = color >> 24;
+		if (alpha == 0)
+			return;
+		if (alpha == 255) {
+			std::fill(dst, dst + count, color);
+			return;
+		}
+
+		int i = 0;
+#ifdef KDR_SSE2
+		const __m128i zero = _mm_setzero_si128();
+		// the color's half of the blend is the same for every pixel
+		const __m128i s = _mm_unpacklo_epi8(_mm_set1_epi32((int)color), zero);
+		const __m128i weighted = _mm_mullo_epi16(s, _mm_set1_epi16((short)alpha));
+		const __m128i inverse = _mm_set1_epi16((short)(255 - alpha));
+		for (; i + 4 <= count; i += 4) {
+			const __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+			const __m128i low  = div255x8(_mm_add_epi16(weighted, _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inverse)));
+			const __m128i high = div255x8(_mm_add_epi16(weighted, _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inverse)));
+			_mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(low, high));
+		}
+#endif
+		for (; i < count; ++i)
+			dst[i] = blend(dst[i], color);
+		return;
+	}
+
+	SoftwareRenderer::SoftwareRenderer(TileData tile_info, int width, int height)
+	: Renderer(tile_info), pixels((size_t)width * height, 0), width(width), height(height) {
+		return;
+	}
+
+	void SoftwareRenderer::begin() {
+		stats.reset();
+		return;
+	}
+
+	void SoftwareRenderer::end() {
+		return;
+	}
+
+	void SoftwareRenderer::flush() {
+		++stats.flushes;
+		return;
+	}
+
+	void SoftwareRenderer::clear(const unsigned int color) {
+		std::fill(pixels.begin(), pixels.end(), color);
+		return;
+	}
+
+	void SoftwareRenderer::resize(int width, int height) {
+		this->width = width;
+		this->height = height;
+		pixels.assign((size_t)width * height, 0);
+		return;
+	}
+
+	void SoftwareRenderer::fillQuad(const vec3* corners, const vec2* uvs, const unsigned char* texels, int texture_width, int texture_height, int channels, const unsigned int color) {
+		++stats.quads_submitted;
+
+		// a pixel is covered if its center is inside, like OpenGL
+		// rows count down from the top, positions count up from the bottom
+		const float left   = std::min(corners[0].x, corners[2].x);
+		const float right  = std::max(corners[0].x, corners[2].x);
+		const float bottom = std::min(corners[0].y, corners[2].y);
+		const float top    = std::max(corners[0].y, corners[2].y);
+		const int col_begin = std::max(0, (int)ceilf(left - 0.5f));
+		const int col_end   = std::min(width, (int)ceilf(right - 0.5f));
+		const int row_begin = std::max(0, (int)floorf(height - 0.5f - top) + 1);
+		const int row_end   = std::min(height, (int)floorf(height - 0.5f - bottom) + 1);
+		if (col_begin >= col_end || row_begin >= row_end)
+			return;
+		const int count = col_end - col_begin;
+
+		if (texels == nullptr) {
+			for (int row = row_begin; row < row_end; ++row)
+				blendColor(&pixels[(size_t)row * width + col_begin], count, color);
+			return;
+		}
+
+		// uvs change evenly from corner 0 to corner 2
+		const float ds = (uvs[2].x - uvs[0].x) / (corners[2].x - corners[0].x);
+		const float dt = (uvs[2].y - uvs[0].y) / (corners[2].y - corners[0].y);
+		// step across texels in 16.16 fixed point
+		const float s_first = uvs[0].x + (col_begin + 0.5f - corners[0].x) * ds;
+		const int32_t u_first = (int32_t)floorf(s_first * texture_width * 65536.0f);
+		const int32_t u_step = (int32_t)(ds * texture_width * 65536.0f);
+
+		span.resize(count);
+		int sampled_row = -1;
+		// opaque texels drawn in white are copied without blending
+		bool copy = false;
+		for (int row = row_begin; row < row_end; ++row) {
+			const float t = uvs[0].y + ((height - row - 0.5f) - corners[0].y) * dt;
+			const int texel_row = std::min(std::max((int)floorf(t * texture_height), 0), texture_height - 1);
+
+			// scaled up textures use the same texels for a few rows
+			if (texel_row != sampled_row) {
+				const unsigned char* source = texels + (size_t)texel_row * texture_width * channels;
+				int32_t u = u_first;
+				uint32_t alphas = 0xFF000000u;
+				for (int i = 0; i < count; ++i, u += u_step) {
+					const int texel = std::min(std::max(u >> 16, 0), texture_width - 1);
+					if (channels == 4)
+						memcpy(&span[i], source + texel * 4, 4);
+					else if (channels == 2)
+						span[i] = source[texel * 2] * 0x010101u | (uint32_t)source[texel * 2 + 1] << 24;
+					else
+						span[i] = 0xFFFFFFu | (uint32_t)source[texel] << 24;
+					alphas &= span[i];
+				}
+				sampled_row = texel_row;
+				copy = color == 0xFFFFFFFFu && alphas == 0xFF000000u;
+			}
+			if (copy)
+				memcpy(&pixels[(size_t)row * width + col_begin], span.data(), count * sizeof(uint32_t));
+			else
+				blendSpan(&pixels[(size_t)row * width + col_begin], span.data(), count, color);
+		}
+		return;
+	}
+
+	void SoftwareRenderer::submitQuad(const vec3* corners, const vec2* uvs, const Texture* texture, const unsigned int color) {
+		if (texture != nullptr)
+			fillQuad(corners, uvs, texture->getPixels(), texture->getWidth(), texture->getHeight(), 4, color);
+		else
+			fillQuad(corners, uvs, nullptr, 0, 0, 0, color);
+		return;
+	}
+
+	void SoftwareRenderer::submitGlyph(const vec3* corners, const vec2* uvs, const Font& font, const unsigned int color) {
+		const ftgl::texture_atlas_t* atlas = font.getAtlas();
+		fillQuad(corners, uvs, atlas->data, (int)atlas->width, (int)atlas->height, (int)atlas->depth, color);
+		return;
+	}
+
+	bool SoftwareRenderer::writePNG(const char* file_path) const {
+		return KDR_WritePNG(file_path, getPixels(), width, height);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+#ifndef _KDR_SOFTWARERENDERER_HPP
+#define _KDR_SOFTWARERENDERER_HPP
+
+#include "renderer.hpp"
+#include <stdint.h>
+
+namespace kdr {
+	/*
+	 A renderer that draws into memory instead of OpenGL
+	 For screenshots and map previews where there's no window
+	 Positions are in pixels with 0, 0 at the bottom left,
+	 the same as drawing with mat4::ortho(0, width, height, 0, ...)
+	 Squares are drawn by the bounds of their transformed corners,
+	 so rotations aren't supported
+	 Textures have to keep their pixels with TextureStorage::Cpu or
+	 TextureStorage::Both, ones that didn't are drawn as plain squares
+	 Fonts should be made with upload set to false
+	 */
+	class SoftwareRenderer : public Renderer {
+	private:
+		/*
+		 The RGBA pixels, top row first
+		 Each pixel is stored the same way as colors
+		 */
+		std::vector<uint32_t> pixels;
+
+		/*
+		 Dimensions of the framebuffer
+		 */
+		int width, height;
+
+		/*
+		 The texels sampled for the row being drawn
+		 */
+		std::vector<uint32_t> span;
+
+		/*
+		 Fills the pixels inside of a square
+		 @param texels: the texture to sample, nullptr for only color
+		 @param channels: 4 for RGBA textures, 2 for font atlases
+		 */
+		void fillQuad(const vec3* corners, const vec2* uvs, const unsigned char* texels, int texture_width, int texture_height, int channels, const unsigned int color);
+
+	protected:
+		/*
+		 Draws a square into the pixels
+		 */
+		void submitQuad(const vec3* corners, const vec2* uvs, const Texture* texture, const unsigned int color) override;
+
+		/*
+		 Draws a glyph from the font's atlas into the pixels
+		 */
+		void submitGlyph(const vec3* corners, const vec2* uvs, const Font& font, const unsigned int color) override;
+
+	public:
+		/*
+		 A renderer that draws into memory
+		 @param width: width of the framebuffer in pixels
+		 @param height: height of the framebuffer in pixels
+		 */
+		SoftwareRenderer(TileData tile_info, int width, int height);
+
+		/*
+		 Resets the stats
+		 Doesn't clear the pixels, call clear for that
+		 */
+		void begin() override;
+
+		/*
+		 Does nothing, pixels are written as they're drawn
+		 */
+		void end() override;
+
+		/*
+		 Counts the flush, pixels are written as they're drawn
+		 */
+		void flush() override;
+
+		/*
+		 Sets every pixel to a color
+		 */
+		void clear(const unsigned int color);
+
+		/*
+		 Changes the size of the framebuffer and clears it
+		 */
+		void resize(int width, int height);
+
+		/*
+		 Writes the framebuffer to a PNG
+		 Returns false if the file couldn't be written
+		 */
+		bool writePNG(const char* file_path) const;
+
+		/*
+		 Returns the RGBA pixels, top row first
+		 */
+		inline const unsigned char* getPixels() const {
+			return (const unsigned char*)pixels.data();
+		}
+
+		/*
+		 Returns the framebuffer's width
+		 */
+		inline int getWidth() const {
+			return width;
+		}
+
+		/*
+		 Returns the framebuffer's height
+		 */
+		inline int getHeight() const {
+			return height;
+		}
+	};
+}
+
+#endif // hi :)
\ No newline at end of file
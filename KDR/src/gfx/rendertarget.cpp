@@ -0,0 +1,71 @@
+#include "rendertarget.hpp"
+#include <iostream>
+#include <stdexcept>
+
+namespace kdr {
+	RenderTarget::RenderTarget(int width, int height)
+	: fbo(NULL), texture(nullptr), previous_fbo(0), dirty(true) {
+		glGenFramebuffers(1, &fbo);
+		create(width, height);
+		return;
+	}
+
+	RenderTarget::~RenderTarget() {
+		glDeleteFramebuffers(1, &fbo);
+		delete texture;
+		return;
+	}
+
+	void RenderTarget::create(int width, int height) {
+		delete texture;
+		texture = new Texture(width, height);
+
+		GLint bound = 0;
+		glGetIntegerv(GL_FRAMEBUFFER_BINDING, &bound);
+		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture->getID(), 0);
+		const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+		glBindFramebuffer(GL_FRAMEBUFFER, bound);
+
+		if (status != GL_FRAMEBUFFER_COMPLETE) {
+			std::runtime_error error = std::runtime_error("Unable to create render target:\nFramebuffer is incomplete");
+			std::cout << error.what() << ' ' << status << std::endl;
+			throw error;
+		}
+		return;
+	}
+
+	void RenderTarget::bind() {
+		glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous_fbo);
+		glGetIntegerv(GL_VIEWPORT, previous_viewport);
+		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+		glViewport(0, 0, texture->getWidth(), texture->getHeight());
+		return;
+	}
+
+	void RenderTarget::unbind() {
+		glBindFramebuffer(GL_FRAMEBUFFER, previous_fbo);
+		glViewport(previous_viewport[0], previous_viewport[1], previous_viewport[2], previous_viewport[3]);
+		return;
+	}
+
+	void RenderTarget::clear(const vec4& color) {
+		GLfloat previous[4];
+		glGetFloatv(GL_COLOR_CLEAR_VALUE, previous);
+		glClearColor(color.x, color.y, color.z, color.w);
+		glClear(GL_COLOR_BUFFER_BIT);
+		// put back the window's clear color
+		glClearColor(previous[0], previous[1], previous[2], previous[3]);
+		return;
+	}
+
+	void RenderTarget::resize(int width, int height) {
+		create(width, height);
+		dirty = true;
+		return;
+	}
+
+	mat4 RenderTarget::getProjection() const {
+		return mat4::ortho(0, (float)texture->getWidth(), (float)texture->getHeight(), 0, -100, 100);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+#ifndef _KDR_RENDERTARGET_HPP
+#define _KDR_RENDERTARGET_HPP
+
+#include "texture.hpp"
+#include "../math/mat4.hpp"
+
+namespace kdr {
+	/*
+	 A framebuffer with a color texture that can be drawn
+	 into instead of the window, then drawn like any Texture
+	 Made for things that rarely change, like UI panels,
+	 so they're drawn once and shown as a single quad
+	 */
+	class RenderTarget {
+	private:
+		/*
+		 OpenGL's ID for the framebuffer
+		 */
+		GLuint fbo;
+		/*
+		 What the framebuffer draws into
+		 */
+		Texture* texture;
+		/*
+		 What was bound before bind so
+		 unbind can put it back
+		 */
+		GLint previous_fbo;
+		GLint previous_viewport[4];
+		/*
+		 Whether the contents need to be drawn again
+		 */
+		bool dirty;
+
+		/*
+		 Makes the texture and attaches it to the framebuffer
+		 */
+		void create(int width, int height);
+
+	public:
+		/*
+		 Creates a framebuffer with an RGBA texture
+		 Throws a runtime error if OpenGL can't use it
+		 @param width: the width of the texture in pixels
+		 @param height: the height of the texture in pixels
+		 */
+		RenderTarget(int width, int height);
+
+		/*
+		 Deletes the framebuffer and its texture from OpenGL
+		 */
+		~RenderTarget();
+
+		/*
+		 Makes everything drawn go into the texture
+		 The viewport is set to the texture's size, so the
+		 projection should be set to getProjection
+		 */
+		void bind();
+
+		/*
+		 Goes back to drawing into whatever was bound before bind
+		 */
+		void unbind();
+
+		/*
+		 Clears the texture to a color
+		 Has to be bound
+		 */
+		void clear(const vec4& color);
+
+		/*
+		 Changes the size of the texture
+		 The contents are lost so it's marked dirty
+		 */
+		void resize(int width, int height);
+
+		/*
+		 Returns a projection that maps pixels in the texture
+		 with 0, 0 at the bottom left like the window
+		 */
+		mat4 getProjection() const;
+
+		/*
+		 Returns the texture to draw the contents with
+		 */
+		inline const Texture* getTexture() const {
+			return texture;
+		}
+
+		inline const int getWidth() const {
+			return texture->getWidth();
+		}
+
+		inline const int getHeight() const {
+			return texture->getHeight();
+		}
+
+		/*
+		 Marks the contents as out of date
+		 */
+		inline void markDirty() {
+			dirty = true;
+		}
+
+		/*
+		 Marks the contents as up to date
+		 */
+		inline void markClean() {
+			dirty = false;
+		}
+
+		/*
+		 Returns true if the contents have to be drawn again
+		 Starts true since a new texture is empty
+		 */
+		inline bool isDirty() const {
+			return dirty;
+		}
+	};
+}
+
+#endif // hi :)
\ No newline at end of file
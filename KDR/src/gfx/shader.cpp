@@ -1,9 +1,15 @@
 #include "shader.hpp"
 #include <GL/glew.h>
 #include "../util/utilfiles.hpp"
+#include "uniformbuffer.hpp"
 
 #include <iostream>
+#include <fstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
 
 namespace kdr {
 	const char* kdr_standard =
@@ -14,8 +20,13 @@ namespace kdr {
 	"layout(location = 2) in float tid;\n"
 	"layout(location = 3) in vec4 color;\n"
 
-	"uniform mat4 pr_matrix;\n"
-	"uniform mat4 vw_matrix = mat4(1.0);\n"
+	// shared by every program through the
+	// UniformBuffer at KDR_FRAME_BINDING
+	"layout(std140) uniform kdr_frame {\n"
+	"	mat4 kdr_projection;\n"
+	"	mat4 kdr_view;\n"
+	"	float kdr_time;\n"
+	"};\n"
 	"uniform mat4 ml_matrix = mat4(1.0);\n"
 
 	"out DATA {\n"
@@ -26,7 +37,7 @@ namespace kdr {
 	"} vs_out;\n"
 
 	"void main() {\n"
-	"	gl_Position = pr_matrix * vw_matrix * ml_matrix * position;\n"
+	"	gl_Position = kdr_projection * kdr_view * ml_matrix * position;\n"
 	"	vs_out.position = ml_matrix * position;\n"
 	"	vs_out.uv = uv;\n"
 	"	vs_out.tid = tid;\n"
@@ -39,7 +50,6 @@ namespace kdr {
 	"layout(location = 0) out vec4 color;\n"
 
 	"uniform vec4 colour;\n"
-	"uniform vec2 light_pos;\n"
 
 	"in DATA\n"
 	"{\n"
@@ -49,28 +59,330 @@ namespace kdr {
 	"	vec4 color;\n"
 	"} fs_in;\n"
 
+	"#ifdef KDR_TEXTURED\n"
 	"uniform sampler2D textures[32];\n"
+	"#endif\n"
+	"#ifdef KDR_PALETTE\n"
+	"uniform sampler2D palette;\n"
+	"#endif\n"
+	"#ifdef KDR_ALPHA_TEST\n"
+	"uniform float alpha_cutoff = 0.5;\n"
+	"#endif\n"
+	"#ifdef KDR_LIGHTING\n"
+	"uniform vec2 light_pos;\n"
+	"uniform float light_radius = 256.0;\n"
+	"uniform vec4 ambient = vec4(0.2, 0.2, 0.2, 1.0);\n"
+	"#endif\n"
 
 	"void main() {\n"
 	"	vec4 texColor = fs_in.color;\n"
+	"#ifdef KDR_TEXTURED\n"
 	"	if (fs_in.tid > 0.0) {\n"
 	"		int tid = int(fs_in.tid - 0.1);\n"
-	"		texColor = fs_in.color * texture(textures[tid], fs_in.uv);\n"
+	"		vec4 sampled = texture(textures[tid], fs_in.uv);\n"
+	"#ifdef KDR_PALETTE\n"
+	"		sampled = texture(palette, vec2(sampled.r, 0.5));\n"
+	"#endif\n"
+	"#ifdef KDR_SDF_TEXT\n"
+	"		float edge = fwidth(sampled.a);\n"
+	"		texColor.a *= smoothstep(0.5 - edge, 0.5 + edge, sampled.a);\n"
+	"#else\n"
+	"		texColor = fs_in.color * sampled;\n"
+	"#endif\n"
 	"	}\n"
+	"#endif\n"
+	"#ifdef KDR_ALPHA_TEST\n"
+	"	if (texColor.a < alpha_cutoff)\n"
+	"		discard;\n"
+	"#endif\n"
+	"#ifdef KDR_LIGHTING\n"
+	"	float light = clamp(1.0 - length(fs_in.position.xy - light_pos) / light_radius, 0.0, 1.0);\n"
+	"	texColor.rgb *= max(ambient.rgb, vec3(light));\n"
+	"#endif\n"
 	"	color = texColor;\n"
 	"}";
 
-	Shader::Shader() {
+	/*
+	 FNV-1a hash of a uniform name
+	 */
+	static unsigned int hashName(const char* name) {
+		unsigned int hash = 2166136261u;
+		while (*name) {
+			hash ^= (unsigned char)*name++;
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	/*
+	 Where compiled program binaries are kept
+	 */
+	std::string shader_cache_path = "res/shaders/";
+
+	/*
+	 Marks the start of a program binary cache file
+	 */
+	static const unsigned int SHADER_CACHE_MAGIC = 0x4B445242; // KDRB
+
+	/*
+	 Continues a 64 bit FNV-1a hash with more bytes
+	 */
+	static unsigned long long hashBytes(unsigned long long hash, const void* data, size_t length) {
+		const unsigned char* bytes = (const unsigned char*)data;
+		for (size_t i = 0; i < length; ++i) {
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	/*
+	 Continues a 64 bit FNV-1a hash with a string
+	 including its terminator so "ab" + "c" and
+	 "a" + "bc" hash differently
+	 */
+	static unsigned long long hashString(unsigned long long hash, const char* string) {
+		return hashBytes(hash, string, strlen(string) + 1);
+	}
+
+	/*
+	 Returns the path of the cached binary for these sources
+	 The driver is part of the key since binaries only work
+	 on the driver that made them
+	 */
+	static std::string cacheFile(const char* vertex_source, const char* fragment_source) {
+		unsigned long long hash = 14695981039346656037ull;
+		hash = hashString(hash, vertex_source);
+		hash = hashString(hash, fragment_source);
+		hash = hashString(hash, (const char*)glGetString(GL_VENDOR));
+		hash = hashString(hash, (const char*)glGetString(GL_RENDERER));
+		hash = hashString(hash, (const char*)glGetString(GL_VERSION));
+
+		char name[32];
+		snprintf(name, sizeof(name), "%016llx.kdrbin", hash);
+		return shader_cache_path + name;
+	}
+
+	/*
+	 Returns true if the driver can save and load program binaries
+	 */
+	static bool binariesSupported() {
+		if (!GLEW_ARB_get_program_binary)
+			return false;
+		GLint formats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+		return formats > 0;
+	}
+
+	/*
+	 Makes a program from a cached binary
+	 Returns NULL if there's no cached binary or the
+	 driver rejected it, so the program has to be compiled
+	 */
+	static GLuint loadBinary(const std::string& path) {
+		std::ifstream stream(path, std::ios::binary | std::ios::ate);
+		if (!stream)
+			return NULL;
+		const std::streamoff file_size = stream.tellg();
+		stream.seekg(0, std::ios::beg);
+
+		unsigned int header[3] = { 0, 0, 0 };
+		stream.read((char*)header, sizeof(header));
+		if (!stream || header[0] != SHADER_CACHE_MAGIC)
+			return NULL;
+		// a corrupt size could ask for gigabytes,
+		// the binary can't be bigger than the file
+		if ((std::streamoff)header[2] != file_size - (std::streamoff)sizeof(header))
+			return NULL;
+
+		std::vector<char> binary(header[2]);
+		stream.read(binary.data(), binary.size());
+		if (!stream)
+			return NULL;
+
+		GLuint program = glCreateProgram();
+		glProgramBinary(program, (GLenum)header[1], binary.data(), (GLsizei)binary.size());
+
+		// drivers reject binaries made by other versions
+		// of themselves, which is fine, we just compile
+		GLint result = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &result);
+		if (result == GL_FALSE) {
+			glDeleteProgram(program);
+			return NULL;
+		}
+		return program;
+	}
+
+	/*
+	 Writes a linked program's binary to the cache
+	 */
+	static void saveBinary(GLuint program, const std::string& path) {
+		GLint length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length <= 0)
+			return;
+
+		std::vector<char> binary(length);
+		GLenum format = 0;
+		glGetProgramBinary(program, length, NULL, &format, binary.data());
+
+		std::ofstream stream(path, std::ios::binary);
+		if (!stream)
+			return;
+		const unsigned int header[3] = { SHADER_CACHE_MAGIC, (unsigned int)format, (unsigned int)length };
+		stream.write((const char*)header, sizeof(header));
+		stream.write(binary.data(), binary.size());
+		return;
+	}
+
+	void KDR_SetShaderCachePath(const char* path) {
+		shader_cache_path = path;
+		return;
+	}
+
+	Shader::Shader()
+	: watcher(nullptr) {
+		// the default shader has always drawn textures
+		defines.push_back("KDR_TEXTURED");
+		shader_id = load(kdr_standard, false, "#shader", "vertex", "fragment");
+		reflect();
+		return;
+	}
+
+	Shader::Shader(const char* const* defines, int define_count)
+	: defines(defines, defines + define_count), watcher(nullptr) {
 		shader_id = load(kdr_standard, false, "#shader", "vertex", "fragment");
+		reflect();
 		return;
 	}
 
-	Shader::Shader(const char* file, bool is_file, const char* type_identifier, const char* vertex_name, const char* fragment_name) {
+	Shader::Shader(const char* file, bool is_file, const char* type_identifier, const char* vertex_name, const char* fragment_name)
+	: Shader(file, is_file, nullptr, 0, type_identifier, vertex_name, fragment_name) {
+		return;
+	}
+
+	Shader::Shader(const char* file, bool is_file, const char* const* defines, int define_count, const char* type_identifier, const char* vertex_name, const char* fragment_name)
+	: defines(defines, defines + define_count), watcher(nullptr) {
+		// remember where the shader came from so it can be reloaded
+		if (is_file) {
+			source_path = file;
+			this->type_identifier = type_identifier;
+			this->vertex_name = vertex_name;
+			this->fragment_name = fragment_name;
+		}
 		shader_id = load(file, is_file, type_identifier, vertex_name, fragment_name);
+		reflect();
+		return;
+	}
+
+	/*
+	 Sends a value to a location of the bound program
+	 */
+	static void sendUniform(int location, UniformKind kind, const void* data, int count) {
+		switch (kind) {
+		case UniformKind::Float: glUniform1fv(location, count, (const float*)data); break;
+		case UniformKind::Int:   glUniform1iv(location, count, (const int*)data);   break;
+		case UniformKind::Vec2:  glUniform2fv(location, count, (const float*)data); break;
+		case UniformKind::Vec3:  glUniform3fv(location, count, (const float*)data); break;
+		case UniformKind::Vec4:  glUniform4fv(location, count, (const float*)data); break;
+		case UniformKind::Mat4:  glUniformMatrix4fv(location, count, GL_FALSE, (const float*)data); break;
+		default: break;
+		}
+		return;
+	}
+
+	/*
+	 Makes an entry for a uniform with no value yet
+	 */
+	static UniformEntry makeEntry(const std::string& name, int location) {
+		UniformEntry entry;
+		entry.hash = hashName(name.c_str());
+		entry.location = location;
+		entry.name = name;
+		return entry;
+	}
+
+	void Shader::reflect() {
+		// uniforms from the last program keep their index
+		// so handles still work, only their location moves
+		for (UniformEntry& entry : uniforms)
+			entry.location = shader_id != NULL ? glGetUniformLocation(shader_id, entry.name.c_str()) : -1;
+		// a program that failed to build has no uniforms
+		if (shader_id == NULL)
+			return;
+
+		GLint count = 0;
+		GLint max_length = 0;
+		glGetProgramiv(shader_id, GL_ACTIVE_UNIFORMS, &count);
+		glGetProgramiv(shader_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+
+		std::vector<char> name(max_length + 1);
+		for (GLint i = 0; i < count; ++i) {
+			GLint size = 0;
+			GLenum type = 0;
+			glGetActiveUniform(shader_id, i, (GLsizei)name.size(), NULL, &size, &type, name.data());
+
+			// uniforms inside of blocks don't have locations
+			GLint location = glGetUniformLocation(shader_id, name.data());
+			if (location == -1)
+				continue;
+
+			std::string uniform_name = name.data();
+			if (indexOf(uniform_name.c_str()) == -1)
+				uniforms.push_back(makeEntry(uniform_name, location));
+
+			// arrays are reported as "name[0]", store
+			// "name" as well since that's how they're set
+			const size_t bracket = uniform_name.find('[');
+			if (bracket != std::string::npos) {
+				uniform_name.erase(bracket);
+				if (indexOf(uniform_name.c_str()) == -1)
+					uniforms.push_back(makeEntry(uniform_name, location));
+			}
+		}
+
+		// every shader that has the frame block reads
+		// from the same binding point
+		bindUniformBlock(KDR_FRAME_BLOCK_NAME, KDR_FRAME_BINDING);
 		return;
 	}
 
 	GLuint Shader::load(const char* file, bool is_file, const char* type_identifier, const char* vertex_name, const char* fragment_name) const {
+		// parse straight into the stages rather than
+		// copying them into a new array
+		ShaderSources sources;
+		std::vector<const char*> define_names;
+		for (const std::string& define : defines)
+			define_names.push_back(define.c_str());
+		ShaderParseOptions options = KDR_ShaderParseOptions(type_identifier, vertex_name, fragment_name);
+		options.defines = define_names.data();
+		options.define_count = (int)define_names.size();
+		if (is_file) {
+			if (!KDR_ParseShaderFile(file, sources, options)) {
+				std::runtime_error error = std::runtime_error("Unable to read shader file:\nCould not open file");
+				std::cout << error.what() << ' ' << file << std::endl;
+				throw error;
+			}
+		}
+		else
+			KDR_ParseShaderString(file, sources, options);
+
+		const char* vertex_source = sources.get(ShaderStage::Vertex).c_str();
+		const char* fragment_source = sources.get(ShaderStage::Fragment).c_str();
+
+		// if these sources were already compiled on this driver
+		// we can skip compiling and linking entirely
+		const bool use_cache = binariesSupported();
+		std::string cache_file;
+		if (use_cache) {
+			cache_file = cacheFile(vertex_source, fragment_source);
+			GLuint cached = loadBinary(cache_file);
+			if (cached != NULL) {
+				return cached;
+			}
+		}
+
 		// program will become our shader_id
 		GLuint program = glCreateProgram();
 		// create shaders using OpenGL and specify 
@@ -79,12 +391,6 @@ namespace kdr {
 		GLuint vertex   = glCreateShader(GL_VERTEX_SHADER);
 		GLuint fragment = glCreateShader(GL_FRAGMENT_SHADER);
 
-		std::string* sources = is_file ? KDR_ReadShaderFile(file, type_identifier, vertex_name, fragment_name)
-									   : KDR_ReadShaderString(file, type_identifier, vertex_name, fragment_name);
-
-		const char* vertex_source = sources[0].c_str();
-		const char* fragment_source = sources[1].c_str();
-
 		// give OpenGL the vertex source as it will be compiled first
 		// and once it's done compiling, get the result of the compilation
 		// and print any errors that happened while compiling
@@ -111,8 +417,11 @@ namespace kdr {
 			// and print it out the terminal
 			glGetShaderInfoLog(vertex, length, &length, &error[0]);
 			std::cout << "Vertex shader:\n" << &error[0] << std::endl;
-			// delete the vertex shader from OpenGL
+			// delete everything we made from OpenGL
+			// so a broken reload doesn't leak them
 			glDeleteShader(vertex);
+			glDeleteShader(fragment);
+			glDeleteProgram(program);
 
 			// delete the error message
 			delete[] error;
@@ -133,7 +442,9 @@ namespace kdr {
 			char* error = new char[length];
 			glGetShaderInfoLog(fragment, length, &length, &error[0]);
 			std::cout << "Fragment shader:\n" << &error[0] << std::endl;
+			glDeleteShader(vertex);
 			glDeleteShader(fragment);
+			glDeleteProgram(program);
 			delete[] error;
 			return NULL;
 		}
@@ -143,23 +454,46 @@ namespace kdr {
 		glAttachShader(program, vertex);
 		glAttachShader(program, fragment);
 
+		// ask OpenGL to keep the binary around
+		// so it can be written to the cache
+		if (use_cache)
+			glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
 		// link our program to OpenGL
-		// and ensure the program
-		// can run in the current OpenGL
-		// state
 		glLinkProgram(program);
+		glGetProgramiv(program, GL_LINK_STATUS, &result);
+		if (result == GL_FALSE) {
+			int length = 0;
+			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+			char* error = new char[length];
+			glGetProgramInfoLog(program, length, &length, &error[0]);
+			std::cout << "Shader program:\n" << &error[0] << std::endl;
+			glDeleteShader(vertex);
+			glDeleteShader(fragment);
+			glDeleteProgram(program);
+			delete[] error;
+			return NULL;
+		}
+
+#ifdef _DEBUG
+		// validating only tells us if the program can run
+		// in the current OpenGL state, which is only useful
+		// while debugging
 		glValidateProgram(program);
+#endif
+
+		if (use_cache)
+			saveBinary(program, cache_file);
 
 		// now we delete our old shaders from OpenGL
-		// including our sources
 		glDeleteShader(vertex);
 		glDeleteShader(fragment);
-		delete[] sources;
 		// return the program AKA shader ID
 		return program;
 	}
 
 	Shader::~Shader() {
+		delete watcher;
 		glDeleteProgram(shader_id);
 		return;
 	}
@@ -174,47 +508,167 @@ namespace kdr {
 		return;
 	}
 
-	int Shader::getUniformLocation(const char* name) {
-		return glGetUniformLocation(shader_id, name);
+	int Shader::indexOf(const char* name) const {
+		const unsigned int hash = hashName(name);
+		for (unsigned int i = 0; i < uniforms.size(); ++i)
+			// only compare the names if the hashes match
+			if (uniforms[i].hash == hash && uniforms[i].name == name)
+				return (int)i;
+		return -1;
+	}
+
+	int Shader::findUniform(const char* name) {
+		const int index = indexOf(name);
+		if (index != -1)
+			return index;
+		// only the first element of an array is reflected,
+		// so "textures[3]" has to be asked for
+		const int location = shader_id != NULL ? glGetUniformLocation(shader_id, name) : -1;
+		uniforms.push_back(makeEntry(name, location));
+		return (int)uniforms.size() - 1;
+	}
+
+	void Shader::setUniformValue(int index, UniformKind kind, const void* data, int count) {
+		if (index < 0)
+			return;
+		UniformEntry& entry = uniforms[index];
+		sendUniform(entry.location, kind, data, count);
+
+		// remember the value so a reload
+		// can give it to the new program
+		const char* bytes = (const char*)data;
+		entry.kind = kind;
+		entry.count = count;
+		entry.value.assign(bytes, bytes + KDR_UniformKindSize(kind) * count);
+		return;
 	}
 
 	void Shader::setUniform1f(const char* name, float value) {
-		glUniform1f(getUniformLocation(name), value);
+		setUniformValue(findUniform(name), UniformKind::Float, &value, 1);
 		return;
 	}
 
 	void Shader::setUniform1fv(const char* name, float* value, int count) {
-		glUniform1fv(getUniformLocation(name), count, value);
+		setUniformValue(findUniform(name), UniformKind::Float, value, count);
 		return;
 	}
 
 	void Shader::setUniform1i(const char* name, int value) {
-		glUniform1i(getUniformLocation(name), value);
+		setUniformValue(findUniform(name), UniformKind::Int, &value, 1);
 		return;
 	}
 
 	void Shader::setUniform1iv(const char* name, int* value, int count) {
-		glUniform1iv(getUniformLocation(name), count, value);
+		setUniformValue(findUniform(name), UniformKind::Int, value, count);
 		return;
 	}
 
 	void Shader::setUniform2f(const char* name, const vec2& vector) {
-		glUniform2f(getUniformLocation(name), vector.x, vector.y);
+		setUniformValue(findUniform(name), UniformKind::Vec2, &vector.x, 1);
 		return;
 	}
 
 	void Shader::setUniform3f(const char* name, const vec3& vector) {
-		glUniform3f(getUniformLocation(name), vector.x, vector.y, vector.z);
+		setUniformValue(findUniform(name), UniformKind::Vec3, &vector.x, 1);
 		return;
 	}
 
 	void Shader::setUniform4f(const char* name, const vec4& vector) {
-		glUniform4f(getUniformLocation(name), vector.x, vector.y, vector.z, vector.w);
+		setUniformValue(findUniform(name), UniformKind::Vec4, &vector.x, 1);
 		return;
 	}
 
 	void Shader::setUniformMat4(const char* name, const mat4& matrix) {
-		glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, matrix.elements);
+		setUniformValue(findUniform(name), UniformKind::Mat4, matrix.elements, 1);
+		return;
+	}
+
+	void Shader::setUniform(const Uniform<float>& uniform, float value) {
+		setUniformValue(uniform.index, UniformKind::Float, &value, 1);
+		return;
+	}
+
+	void Shader::setUniform(const Uniform<int>& uniform, int value) {
+		setUniformValue(uniform.index, UniformKind::Int, &value, 1);
+		return;
+	}
+
+	void Shader::setUniform(const Uniform<vec2>& uniform, const vec2& vector) {
+		setUniformValue(uniform.index, UniformKind::Vec2, &vector.x, 1);
+		return;
+	}
+
+	void Shader::setUniform(const Uniform<vec3>& uniform, const vec3& vector) {
+		setUniformValue(uniform.index, UniformKind::Vec3, &vector.x, 1);
+		return;
+	}
+
+	void Shader::setUniform(const Uniform<vec4>& uniform, const vec4& vector) {
+		setUniformValue(uniform.index, UniformKind::Vec4, &vector.x, 1);
+		return;
+	}
+
+	void Shader::setUniform(const Uniform<mat4>& uniform, const mat4& matrix) {
+		setUniformValue(uniform.index, UniformKind::Mat4, matrix.elements, 1);
+		return;
+	}
+
+	bool Shader::watch() {
+		// shaders made from strings have no file to watch
+		if (source_path.empty())
+			return false;
+		if (watcher == nullptr)
+			watcher = new ShaderWatcher(source_path.c_str());
+		return true;
+	}
+
+	bool Shader::reload() {
+		if (watcher == nullptr || !watcher->hasChanged())
+			return false;
+
+		GLuint program = NULL;
+		try {
+			program = load(source_path.c_str(), true, type_identifier.c_str(), vertex_name.c_str(), fragment_name.c_str());
+		}
+		catch (const std::runtime_error&) {
+			program = NULL;
+		}
+
+		// a broken shader is normal while editing
+		// so keep drawing with the one that worked
+		if (program == NULL) {
+			std::cout << "Shader reload failed, keeping the old program: " << source_path << std::endl;
+			return false;
+		}
+
+		// swap in the new program and find its uniforms
+		GLint current = 0;
+		glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+		const GLuint old_id = shader_id;
+		glDeleteProgram(shader_id);
+		shader_id = program;
+		reflect();
+
+		// the new program starts with default uniforms
+		// so give it every value the old one had
+		glUseProgram(shader_id);
+		for (const UniformEntry& entry : uniforms)
+			if (entry.kind != UniformKind::None && entry.location != -1)
+				sendUniform(entry.location, entry.kind, entry.value.data(), entry.count);
+
+		// leave the old binding alone unless it
+		// was the program we just replaced
+		if ((GLuint)current != old_id)
+			glUseProgram(current);
+
+		std::cout << "Shader reloaded: " << source_path << std::endl;
+		return true;
+	}
+
+	void Shader::bindUniformBlock(const char* block_name, GLuint binding) {
+		const GLuint index = glGetUniformBlockIndex(shader_id, block_name);
+		if (index != GL_INVALID_INDEX)
+			glUniformBlockBinding(shader_id, index, binding);
 		return;
 	}
 
@@ -3,6 +3,9 @@
 
 #include "../math/vec.hpp"
 #include "../math/mat4.hpp"
+#include <string>
+#include <vector>
+#include "shaderwatcher.hpp"
 
 namespace kdr {
 	/*
@@ -10,6 +13,80 @@ namespace kdr {
 	 */
 	typedef unsigned int GLuint;
 
+	/*
+	 A handle to a uniform
+	 Look it up once with Shader::getUniform and
+	 set it without any name lookups
+	 Handles stay valid when the shader is reloaded
+	 T is the type the uniform is set with
+	 */
+	template<typename T>
+	struct Uniform {
+		/*
+		 Where the uniform is in the shader's uniforms
+		 -1 if the handle wasn't looked up
+		 */
+		int index = -1;
+	};
+
+	/*
+	 How a uniform's value is sent to OpenGL
+	 */
+	enum class UniformKind {
+		None  = 0,
+		Float = 1,
+		Int   = 2,
+		Vec2  = 3,
+		Vec3  = 4,
+		Vec4  = 5,
+		Mat4  = 6
+	};
+
+	/*
+	 A uniform found when reflecting the shader
+	 */
+	struct UniformEntry {
+		/*
+		 FNV-1a hash of the name so lookups
+		 rarely need to compare strings
+		 */
+		unsigned int hash;
+		/*
+		 The location of the uniform
+		 -1 if the current program doesn't have it,
+		 which OpenGL ignores when setting
+		 */
+		int location;
+		/*
+		 The name of the uniform
+		 */
+		std::string name;
+		/*
+		 The last value set so it can be
+		 set again after a reload
+		 */
+		UniformKind kind = UniformKind::None;
+		int count = 0;
+		std::vector<char> value;
+	};
+
+	/*
+	 Returns the size of one element of a kind of uniform in bytes
+	 */
+	inline size_t KDR_UniformKindSize(UniformKind kind) {
+		switch (kind) {
+		case UniformKind::Float: return sizeof(float);
+		case UniformKind::Int:   return sizeof(int);
+		case UniformKind::Vec2:  return sizeof(float) * 2;
+		case UniformKind::Vec3:  return sizeof(float) * 3;
+		case UniformKind::Vec4:  return sizeof(float) * 4;
+		case UniformKind::Mat4:  return sizeof(float) * 16;
+		default: return 0;
+		}
+	}
+
+	class ShaderVariants;
+
 	/*
 	 Program ran on the GPU
 	 KDR uses fragment and vertex shaders
@@ -22,6 +99,54 @@ namespace kdr {
 		 */
 		GLuint shader_id;
 
+		/*
+		 Every active uniform of the program and every
+		 name asked for, filled after linking
+		 Entries keep their index when the program is
+		 reloaded so Uniform handles stay valid
+		 */
+		std::vector<UniformEntry> uniforms;
+
+		/*
+		 What the shader was loaded from
+		 Only set for shaders read from a file
+		 so they can be reloaded
+		 */
+		std::string source_path, type_identifier, vertex_name, fragment_name;
+
+		/*
+		 Defines added to every stage after #version
+		 Kept so reloading builds the same permutation
+		 */
+		std::vector<std::string> defines;
+
+		/*
+		 Watches the source file when hot reloading
+		 nullptr when the shader isn't watched
+		 */
+		ShaderWatcher* watcher;
+
+		// ShaderVariants sets the same uniform
+		// values on every program it builds
+		friend class ShaderVariants;
+
+		/*
+		 Sends a uniform's value to OpenGL and remembers
+		 it so a reload can set it again
+		 @param index: where the uniform is in uniforms
+		 @param count: how many elements are in data
+		 */
+		void setUniformValue(int index, UniformKind kind, const void* data, int count);
+
+		/*
+		 Asks OpenGL where every uniform already known is
+		 in the linked program, then adds the active uniforms
+		 that aren't known yet
+		 Also binds the KDR frame uniform block
+		 if the program uses it
+		 */
+		void reflect();
+
 		/*
 		 Loads the shader and links the program to OpenGL
 		 @param file: the string/path of the file
@@ -32,16 +157,24 @@ namespace kdr {
 		GLuint load(const char* file, bool is_file, const char* type_identifier, const char* vertex_name, const char* fragment_name) const;
 
 		/*
-		Looks in the string for "name"
-		Returns the layout index of "name"
+		Returns where "name" is in uniforms or -1
 		*/
-		int getUniformLocation(const char* name);
+		int indexOf(const char* name) const;
+
+		/*
+		Looks in the reflected uniforms for "name"
+		and asks OpenGL if it isn't there, IE "textures[3]"
+		Names the program doesn't have are still added so
+		their values can be set if a reload adds them
+		Returns where "name" is in uniforms
+		*/
+		int findUniform(const char* name);
 
 	public:
 		/*
 		 Creates the KDR default shader
-		 which sets the projection matrix
-		 to the dimensions of the screen
+		 which reads the projection and view from
+		 the kdr_frame UniformBuffer, see FrameData
 		 */
 		Shader();
 
@@ -54,6 +187,20 @@ namespace kdr {
 		 */
 		Shader(const char* file, bool is_file, const char* type_identifier, const char* vertex_name, const char* fragment_name);
 
+		/*
+		 Creates the KDR default shader with its own defines
+		 See ShaderVariants for the features it understands
+		 @param defines: each is "NAME" or "NAME VALUE"
+		 */
+		Shader(const char* const* defines, int define_count);
+
+		/*
+		 Reads a shader from either a string or a file
+		 and adds the defines after each stage's #version
+		 @param defines: each is "NAME" or "NAME VALUE"
+		 */
+		Shader(const char* file, bool is_file, const char* const* defines, int define_count, const char* type_identifier, const char* vertex_name, const char* fragment_name);
+
 		/*
 		 Deletes the shader from OpenGL
 		 */
@@ -102,12 +249,81 @@ namespace kdr {
 		*/
 		void setUniformMat4(const char* name, const mat4& matrix);
 
+		/*
+		 Returns a handle to the uniform so it can be
+		 set without looking up its name again
+		 */
+		template<typename T>
+		inline Uniform<T> getUniform(const char* name) {
+			Uniform<T> uniform;
+			uniform.index = findUniform(name);
+			return uniform;
+		}
+
+		/*
+		Sets the uniform to 1 float value
+		*/
+		void setUniform(const Uniform<float>& uniform, float value);
+		/*
+		Sets the uniform to 1 int value
+		*/
+		void setUniform(const Uniform<int>& uniform, int value);
+		/*
+		Sets the uniform to 2 float values
+		*/
+		void setUniform(const Uniform<vec2>& uniform, const vec2& vector);
+		/*
+		Sets the uniform to 3 float values
+		*/
+		void setUniform(const Uniform<vec3>& uniform, const vec3& vector);
+		/*
+		Sets the uniform to 4 float values
+		*/
+		void setUniform(const Uniform<vec4>& uniform, const vec4& vector);
+		/*
+		Sets the uniform to a matrix
+		*/
+		void setUniform(const Uniform<mat4>& uniform, const mat4& matrix);
+
+		/*
+		 Starts watching the shader's file on a background thread
+		 so reload can pick up changes
+		 Returns false if the shader wasn't read from a file
+		 */
+		bool watch();
+
+		/*
+		 Rebuilds the program if the watched file changed
+		 Call once a frame, outside of drawing, on the
+		 thread that owns the OpenGL context
+		 The old program is kept if the new source fails to build
+		 and every uniform value set so far is set again on the new one
+		 Returns true if the program was swapped
+		 */
+		bool reload();
+
+		/*
+		 Binds the shader's uniform block to a uniform buffer
+		 binding point so every shader bound to the same point
+		 reads the same UniformBuffer
+		 Does nothing if the shader doesn't have the block
+		 */
+		void bindUniformBlock(const char* block_name, GLuint binding);
+
 		/*
 		 Returns the ID of the shader
 		 as a program in OpenGL
 		 */
 		GLuint getID() const;
 	};
+
+	/*
+	 Sets the folder compiled shader programs are cached in
+	 Cached programs skip compiling and linking on the next launch
+	 Defaults to res/shaders/
+	 @param path: the folder, ending with a slash
+	 */
+	void KDR_SetShaderCachePath(const char* path);
 }
 
 #endif // hi :)
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "shadervariant.hpp"
+#include <GL/glew.h>
+#include <string.h>
+
+namespace kdr {
+	const char* shader_feature_defines[SHADER_FEATURE_COUNT] = {
+		"KDR_TEXTURED",
+		"KDR_ALPHA_TEST",
+		"KDR_SDF_TEXT",
+		"KDR_PALETTE",
+		"KDR_LIGHTING"
+	};
+
+	const char* KDR_ShaderFeatureDefine(unsigned int feature) {
+		for (unsigned int i = 0; i < SHADER_FEATURE_COUNT; ++i)
+			if (feature == (1u << i))
+				return shader_feature_defines[i];
+		return nullptr;
+	}
+
+	ShaderVariants::ShaderVariants()
+	: is_file(false) {
+		memset(variants, 0, sizeof(variants));
+		return;
+	}
+
+	ShaderVariants::ShaderVariants(const char* file, bool is_file, const char* type_identifier, const char* vertex_name, const char* fragment_name)
+	: source(file), type_identifier(type_identifier), vertex_name(vertex_name), fragment_name(fragment_name), is_file(is_file) {
+		memset(variants, 0, sizeof(variants));
+		return;
+	}
+
+	ShaderVariants::~ShaderVariants() {
+		for (Shader* variant : variants)
+			delete variant;
+		return;
+	}
+
+	Shader* ShaderVariants::get(unsigned int features) {
+		features &= SHADER_VARIANT_COUNT - 1;
+		if (variants[features] != nullptr)
+			return variants[features];
+
+		// turn the mask into defines
+		const char* defines[SHADER_FEATURE_COUNT];
+		int define_count = 0;
+		for (unsigned int i = 0; i < SHADER_FEATURE_COUNT; ++i)
+			if (features & (1 << i))
+				defines[define_count++] = shader_feature_defines[i];
+
+		Shader* variant = source.empty() ? new Shader(defines, define_count)
+			: new Shader(source.c_str(), is_file, defines, define_count, type_identifier.c_str(), vertex_name.c_str(), fragment_name.c_str());
+		variants[features] = variant;
+
+		// give the new program every value the others have
+		if (!values.empty()) {
+			GLint current = 0;
+			glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+			variant->bind();
+			for (const UniformEntry& entry : values)
+				variant->setUniformValue(variant->findUniform(entry.name.c_str()), entry.kind, entry.value.data(), entry.count);
+			glUseProgram(current);
+		}
+		return variant;
+	}
+
+	void ShaderVariants::setUniformValue(const char* name, UniformKind kind, const void* data, int count) {
+		// glUniform sets the bound program so every
+		// variant has to be bound in turn
+		GLint current = 0;
+		glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+		for (Shader* variant : variants) {
+			if (variant == nullptr)
+				continue;
+			variant->bind();
+			variant->setUniformValue(variant->findUniform(name), kind, data, count);
+		}
+		glUseProgram(current);
+
+		const char* bytes = (const char*)data;
+		for (UniformEntry& entry : values) {
+			if (entry.name == name) {
+				entry.kind = kind;
+				entry.count = count;
+				entry.value.assign(bytes, bytes + KDR_UniformKindSize(kind) * count);
+				return;
+			}
+		}
+
+		UniformEntry entry;
+		entry.hash = 0;
+		entry.location = -1;
+		entry.name = name;
+		entry.kind = kind;
+		entry.count = count;
+		entry.value.assign(bytes, bytes + KDR_UniformKindSize(kind) * count);
+		values.push_back(entry);
+		return;
+	}
+
+	void ShaderVariants::setUniform1f(const char* name, float value) {
+		setUniformValue(name, UniformKind::Float, &value, 1);
+		return;
+	}
+
+	void ShaderVariants::setUniform1i(const char* name, int value) {
+		setUniformValue(name, UniformKind::Int, &value, 1);
+		return;
+	}
+
+	void ShaderVariants::setUniform1iv(const char* name, int* value, int count) {
+		setUniformValue(name, UniformKind::Int, value, count);
+		return;
+	}
+
+	void ShaderVariants::setUniform2f(const char* name, const vec2& vector) {
+		setUniformValue(name, UniformKind::Vec2, &vector.x, 1);
+		return;
+	}
+
+	void ShaderVariants::setUniform4f(const char* name, const vec4& vector) {
+		setUniformValue(name, UniformKind::Vec4, &vector.x, 1);
+		return;
+	}
+
+	void ShaderVariants::setUniformMat4(const char* name, const mat4& matrix) {
+		setUniformValue(name, UniformKind::Mat4, matrix.elements, 1);
+		return;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+#ifndef _KDR_SHADERVARIANT_HPP
+#define _KDR_SHADERVARIANT_HPP
+
+#include "shader.hpp"
+
+/*
+ Samples textures[tid] for sprites with a texture
+ Without it every sprite is a flat color
+ */
+#define SHADER_FEATURE_TEXTURED   (1 << 0)
+/*
+ Discards pixels with less alpha than alpha_cutoff
+ */
+#define SHADER_FEATURE_ALPHA_TEST (1 << 1)
+/*
+ Treats the texture's alpha as a signed distance field
+ for sharp text at any scale
+ */
+#define SHADER_FEATURE_SDF_TEXT   (1 << 2)
+/*
+ Looks up the texture's red channel in the palette texture
+ */
+#define SHADER_FEATURE_PALETTE    (1 << 3)
+/*
+ Lights pixels around light_pos and leaves
+ the rest at ambient
+ */
+#define SHADER_FEATURE_LIGHTING   (1 << 4)
+
+/*
+ The amount of features and the amount
+ of programs they can make
+ */
+#define SHADER_FEATURE_COUNT (5)
+#define SHADER_VARIANT_COUNT (1 << SHADER_FEATURE_COUNT)
+
+namespace kdr {
+	/*
+	 Every permutation of a shader's features
+	 Each feature is a #define so the GPU only runs
+	 the code a batch actually needs
+	 Programs are built the first time they're asked for
+	 and kept by their feature mask
+	 */
+	class ShaderVariants {
+	private:
+		/*
+		 The source every variant is built from
+		 Empty for the KDR default shader
+		 */
+		std::string source, type_identifier, vertex_name, fragment_name;
+		bool is_file;
+
+		/*
+		 Indexed by feature mask, nullptr
+		 until the variant is used
+		 */
+		Shader* variants[SHADER_VARIANT_COUNT];
+
+		/*
+		 Every uniform value set so far so variants built
+		 later start with the same values
+		 */
+		std::vector<UniformEntry> values;
+
+		/*
+		 Sets a uniform on every built variant and
+		 remembers it for the ones that aren't built yet
+		 */
+		void setUniformValue(const char* name, UniformKind kind, const void* data, int count);
+
+	public:
+		/*
+		 Variants of the KDR default shader
+		 */
+		ShaderVariants();
+
+		/*
+		 Variants of a shader read from a string or file
+		 The shader checks the SHADER_FEATURE names
+		 below with #ifdef
+		 */
+		ShaderVariants(const char* file, bool is_file, const char* type_identifier, const char* vertex_name, const char* fragment_name);
+
+		/*
+		 Deletes every variant that was built
+		 */
+		~ShaderVariants();
+
+		/*
+		 Returns the program for the features, building
+		 it if this is the first time it's used
+		 @param features: SHADER_FEATURE flags or'd together
+		 */
+		Shader* get(unsigned int features);
+
+		/*
+		Sets the variable of name to 1 float value on every variant
+		*/
+		void setUniform1f(const char* name, float value);
+		/*
+		Sets the variable of name to 1 int value on every variant
+		*/
+		void setUniform1i(const char* name, int value);
+		/*
+		Sets the variable of name to an array of ints on every variant
+		*/
+		void setUniform1iv(const char* name, int* value, int count);
+		/*
+		Sets the variable of name to 2 float values on every variant
+		*/
+		void setUniform2f(const char* name, const vec2& vector);
+		/*
+		Sets the variable of name to 4 float values on every variant
+		*/
+		void setUniform4f(const char* name, const vec4& vector);
+		/*
+		Sets the variable of name to a matrix on every variant
+		*/
+		void setUniformMat4(const char* name, const mat4& matrix);
+	};
+
+	/*
+	 Returns the #define a feature is compiled with
+	 IE SHADER_FEATURE_TEXTURED is KDR_TEXTURED
+	 @param feature: a single SHADER_FEATURE flag
+	 Returns nullptr if it isn't exactly one feature
+	 */
+	const char* KDR_ShaderFeatureDefine(unsigned int feature);
+}
+
+#endif // hi :)
\ No newline at end of file
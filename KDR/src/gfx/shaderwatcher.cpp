@@ -0,0 +1,85 @@
+#include "shaderwatcher.hpp"
+#include <chrono>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <string.h>
+#endif
+
+namespace kdr {
+	ShaderWatcher::ShaderWatcher(const char* file_path)
+	: file_path(file_path), changed(false), running(true) {
+		thread = std::thread(&ShaderWatcher::watch, this);
+		return;
+	}
+
+	ShaderWatcher::~ShaderWatcher() {
+		running = false;
+		if (thread.joinable())
+			thread.join();
+		return;
+	}
+
+	bool ShaderWatcher::hasChanged() {
+		// reset the flag so each change is only reported once
+		return changed.exchange(false);
+	}
+
+#ifdef __linux__
+	void ShaderWatcher::watch() {
+		// editors often save by writing a new file and renaming
+		// it over the old one, so we watch the folder and
+		// look for the file's name instead of the file itself
+		const size_t slash = file_path.find_last_of('/');
+		const std::string folder = slash == std::string::npos ? "." : file_path.substr(0, slash);
+		const std::string name = slash == std::string::npos ? file_path : file_path.substr(slash + 1);
+
+		const int fd = inotify_init1(IN_NONBLOCK);
+		if (fd < 0)
+			return;
+		const int wd = inotify_add_watch(fd, folder.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+		if (wd < 0) {
+			close(fd);
+			return;
+		}
+
+		alignas(inotify_event) char events[4096];
+		pollfd poller = { fd, POLLIN, 0 };
+		while (running) {
+			// wake up every so often to check running
+			if (poll(&poller, 1, SHADER_WATCH_INTERVAL) <= 0)
+				continue;
+
+			const ssize_t length = read(fd, events, sizeof(events));
+			for (ssize_t i = 0; i < length;) {
+				const inotify_event* event = (const inotify_event*)&events[i];
+				if (event->len > 0 && name == event->name)
+					changed = true;
+				i += sizeof(inotify_event) + event->len;
+			}
+		}
+
+		inotify_rm_watch(fd, wd);
+		close(fd);
+		return;
+	}
+#else
+	void ShaderWatcher::watch() {
+		// without inotify we compare the file's
+		// modification time every interval
+		struct stat info;
+		time_t last_write = stat(file_path.c_str(), &info) == 0 ? info.st_mtime : 0;
+		while (running) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(SHADER_WATCH_INTERVAL));
+			if (stat(file_path.c_str(), &info) == 0 && info.st_mtime != last_write) {
+				last_write = info.st_mtime;
+				changed = true;
+			}
+		}
+		return;
+	}
+#endif
+}
\ No newline at end of file
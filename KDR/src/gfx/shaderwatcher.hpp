@@ -0,0 +1,72 @@
+#ifndef _KDR_SHADERWATCHER_HPP
+#define _KDR_SHADERWATCHER_HPP
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+/*
+ How often the watcher checks if it
+ should stop, in milliseconds
+ */
+#define SHADER_WATCH_INTERVAL (100)
+
+namespace kdr {
+	/*
+	 Watches a file from a background thread and
+	 flags it when the file gets written to
+	 Uses inotify on Linux and checks the file's
+	 modification time everywhere else
+	 Does not touch OpenGL, the owner reacts to
+	 the flag on the thread that owns the context
+	 */
+	class ShaderWatcher {
+	private:
+		/*
+		 The file being watched
+		 */
+		std::string file_path;
+
+		/*
+		 Set by the watching thread when
+		 the file changes
+		 */
+		std::atomic<bool> changed;
+
+		/*
+		 Whether the watching thread should keep going
+		 */
+		std::atomic<bool> running;
+
+		/*
+		 The thread that watches the file
+		 */
+		std::thread thread;
+
+		/*
+		 Watches the file until running is false
+		 */
+		void watch();
+
+	public:
+		/*
+		 Starts watching the file
+		 @param file_path: path to the file
+		 */
+		ShaderWatcher(const char* file_path);
+
+		/*
+		 Stops watching the file and waits
+		 for the thread to finish
+		 */
+		~ShaderWatcher();
+
+		/*
+		 Returns true if the file changed since the last
+		 time this was called
+		 */
+		bool hasChanged();
+	};
+}
+
+#endif // hi :)
\ No newline at end of file
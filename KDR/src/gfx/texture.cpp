@@ -4,17 +4,39 @@
 
 namespace kdr {
 	Texture::Texture(const char* file_path) {
-		load(file_path);
+		load(file_path, TextureStorage::Gpu);
+		return;
+	}
+
+	Texture::Texture(const char* file_path, TextureStorage storage) {
+		load(file_path, storage);
+		return;
+	}
+
+	Texture::Texture(int width, int height)
+	: local_buffer(nullptr), width(width), height(height), bits_per_pixel(32) {
+		glGenTextures(1, &texture_id);
+		glBindTexture(GL_TEXTURE_2D, texture_id);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		// NULL data leaves the texture's contents undefined
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+		glBindTexture(GL_TEXTURE_2D, NULL);
 		return;
 	}
 
 	Texture::~Texture() {
 		// free the memory from OpenGL
-		glDeleteTextures(1, &texture_id);
+		if (texture_id != 0)
+			glDeleteTextures(1, &texture_id);
+		if (local_buffer)
+			stbi_image_free(local_buffer);
 		return;
 	}
 
-	void Texture::load(const char* file_path) {
+	void Texture::load(const char* file_path, TextureStorage storage) {
 		// flip the image upwards
 		stbi_set_flip_vertically_on_load(true);
 		// load the local_buffer with the texture data
@@ -22,6 +44,11 @@ namespace kdr {
 		// and set the texture to 4 channels
 		local_buffer = stbi_load(file_path, &width, &height, &bits_per_pixel, 4);
 
+		// nothing to give OpenGL
+		texture_id = 0;
+		if (storage == TextureStorage::Cpu)
+			return;
+
 		// generate a new texture in OpenGL
 		glGenTextures(1, &texture_id);
 		// bind the texture so we can edit some details
@@ -43,9 +70,12 @@ namespace kdr {
 		glBindTexture(GL_TEXTURE_2D, NULL);
 
 		// if the local buffer isn't nullptr
-		if (local_buffer)
+		// and it isn't being kept
+		if (local_buffer && storage == TextureStorage::Gpu) {
 			// free it
 			stbi_image_free(local_buffer);
+			local_buffer = nullptr;
+		}
 		return;
 	}
 
@@ -4,6 +4,24 @@
 #include <GL/glew.h>
 
 namespace kdr {
+	/*
+	Where a texture's pixels are kept
+	*/
+	enum class TextureStorage {
+		/*
+		Only in OpenGL, the pixels are freed once uploaded
+		*/
+		Gpu,
+		/*
+		Only in memory, OpenGL isn't touched so no context is needed
+		*/
+		Cpu,
+		/*
+		In OpenGL and in memory
+		*/
+		Both
+	};
+
 	/*
 	Basic texture for OpenGL
 	*/
@@ -30,7 +48,7 @@ namespace kdr {
 		/*
 		Loads the texture into memory
 		*/
-		void load(const char* file_path);
+		void load(const char* file_path, TextureStorage storage);
 
 	public:
 		/*
@@ -39,7 +57,20 @@ namespace kdr {
 		Texture(const char* file_path);
 
 		/*
-		Deletes the texture from OpenGL
+		Basic texture that can keep its pixels in memory
+		for things like the SoftwareRenderer
+		*/
+		Texture(const char* file_path, TextureStorage storage);
+
+		/*
+		Creates an empty RGBA texture to be drawn into
+		IE by a RenderTarget or with glTexSubImage2D
+		*/
+		Texture(int width, int height);
+
+		/*
+		Deletes the texture from OpenGL and
+		frees the pixels if they were kept
 		*/
 		~Texture();
 
@@ -67,6 +98,13 @@ namespace kdr {
 		Returns the ID of the texture
 		*/
 		inline GLuint getID() const { return texture_id; }
+
+		/*
+		Returns the RGBA pixels, the first row being the bottom of the image
+		Returns nullptr unless the texture was loaded with
+		TextureStorage::Cpu or TextureStorage::Both
+		*/
+		inline const unsigned char* getPixels() const { return local_buffer; }
 	};
 }
 
@@ -0,0 +1,36 @@
+#include "uniformbuffer.hpp"
+
+namespace kdr {
+	static_assert(sizeof(FrameData) == 144, "FrameData has to match the std140 layout of kdr_frame");
+
+	UniformBuffer::UniformBuffer(GLuint binding, GLsizeiptr size)
+	: binding(binding), size(size) {
+		glGenBuffers(1, &buffer_id);
+		glBindBuffer(GL_UNIFORM_BUFFER, buffer_id);
+		// the data changes every frame so
+		// it's going to be a dynamic draw
+		glBufferData(GL_UNIFORM_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_UNIFORM_BUFFER, NULL);
+		// bind it to its binding point right away so
+		// shaders can read it without binding it again
+		bind();
+		return;
+	}
+
+	UniformBuffer::~UniformBuffer() {
+		glDeleteBuffers(1, &buffer_id);
+		return;
+	}
+
+	void UniformBuffer::setData(const void* data, GLsizeiptr data_size, GLintptr offset) {
+		glBindBuffer(GL_UNIFORM_BUFFER, buffer_id);
+		glBufferSubData(GL_UNIFORM_BUFFER, offset, data_size, data);
+		glBindBuffer(GL_UNIFORM_BUFFER, NULL);
+		return;
+	}
+
+	void UniformBuffer::bind() const {
+		glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer_id);
+		return;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#ifndef _KDR_UNIFORMBUFFER_HPP
+#define _KDR_UNIFORMBUFFER_HPP
+
+#include <GL/glew.h>
+#include "../math/mat4.hpp"
+
+/*
+ The name of the uniform block that holds
+ per-frame data in a shader
+ */
+#define KDR_FRAME_BLOCK_NAME "kdr_frame"
+
+/*
+ The binding point every shader's
+ frame block is bound to
+ */
+#define KDR_FRAME_BINDING (0)
+
+namespace kdr {
+	/*
+	 Per-frame data shared by every shader
+	 Laid out with std140 rules so it can be
+	 copied straight into a UniformBuffer
+	 Matches this block in GLSL:
+
+	 layout(std140) uniform kdr_frame {
+	 	mat4 kdr_projection;
+	 	mat4 kdr_view;
+	 	float kdr_time;
+	 };
+	 */
+	struct FrameData {
+		mat4 projection;
+		mat4 view;
+		float time;
+		/*
+		 std140 rounds the block up
+		 to a multiple of a vec4
+		 */
+		float padding[3];
+	};
+
+	/*
+	 A buffer of uniforms that can be shared
+	 between every shader bound to its binding point
+	 */
+	class UniformBuffer {
+	private:
+		/*
+		 OpenGL's ID for this buffer
+		 */
+		GLuint buffer_id;
+
+		/*
+		 The binding point shaders read this buffer from
+		 */
+		GLuint binding;
+
+		/*
+		 The size of the buffer in bytes
+		 */
+		GLsizeiptr size;
+
+	public:
+		/*
+		 A buffer of uniforms that can be shared
+		 between every shader bound to its binding point
+		 @param binding: the binding point the buffer is bound to
+		 @param size: the size of the buffer in bytes
+		 */
+		UniformBuffer(GLuint binding, GLsizeiptr size);
+
+		/*
+		 Deletes the buffer from OpenGL
+		 */
+		~UniformBuffer();
+
+		/*
+		 Copies data into the buffer
+		 @param data: the data being copied
+		 @param data_size: the size of data in bytes
+		 @param offset: where in the buffer the data is copied to
+		 */
+		void setData(const void* data, GLsizeiptr data_size, GLintptr offset = 0);
+
+		/*
+		 Binds the buffer to its binding point
+		 */
+		void bind() const;
+
+		/*
+		 Returns the binding point of the buffer
+		 */
+		inline GLuint getBinding() const {
+			return binding;
+		}
+	};
+}
+
+#endif // hi :)
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include "window.hpp"
+#include "framecapture.hpp"
 #include "../base/game.hpp"
 #include "input/input.hpp"
+#include "input/inputqueue.hpp"
+#include "../util/profiler.hpp"
 #include <iostream>
 #include <vcruntime_exception.h>
 #include <functional>
@@ -18,13 +21,32 @@ namespace kdr {
 		Window* win = (Window*)glfwGetWindowUserPointer(window);
 		win->width = width;
 		win->height = height;
+		win->received_events = true;
 		win->game.windowResize();
 		return;
 	}
 
+	/*
+	 Queues an input event stamped with the current time
+	 */
+	static void pushEvent(InputEventType type, int code, int action, int mods, double x, double y) {
+		InputEvent event;
+		event.type = type;
+		event.code = code;
+		event.action = action;
+		event.mods = mods;
+		event.x = x;
+		event.y = y;
+		event.time = glfwGetTime();
+		KDR_PushInputEvent(event);
+		return;
+	}
+
 	void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
 		// get the current window
 		Window* win = (Window*)glfwGetWindowUserPointer(window);
+		win->received_events = true;
+		pushEvent(InputEventType::Key, key, action, mods, 0.0, 0.0);
 		KDR_SetKey(key, action != GLFW_RELEASE);
 		return;
 	}
@@ -32,6 +54,8 @@ namespace kdr {
 	void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
 		// get the current window
 		Window* win = (Window*)glfwGetWindowUserPointer(window);
+		win->received_events = true;
+		pushEvent(InputEventType::Button, button, action, mods, win->x, win->y);
 		KDR_SetButton(button, action != GLFW_RELEASE);
 		return;
 	}
@@ -41,11 +65,43 @@ namespace kdr {
 		Window* win = (Window*)glfwGetWindowUserPointer(window);
 		win->x = x;
 		win->y = y;
+		win->received_events = true;
+		KDR_SetCursor(x, y);
+		pushEvent(InputEventType::Cursor, 0, 0, 0, x, y);
+		return;
+	}
+
+	void charCallback(GLFWwindow* window, unsigned int codepoint) {
+		// get the current window
+		Window* win = (Window*)glfwGetWindowUserPointer(window);
+		win->received_events = true;
+		pushEvent(InputEventType::Char, (int)codepoint, 0, 0, 0.0, 0.0);
+		return;
+	}
+
+	void scrollCallback(GLFWwindow* window, double x_offset, double y_offset) {
+		// get the current window
+		Window* win = (Window*)glfwGetWindowUserPointer(window);
+		win->received_events = true;
+		pushEvent(InputEventType::Scroll, 0, 0, 0, x_offset, y_offset);
 		return;
 	}
 
-	Window::Window(Game& game, const char* title, unsigned short width, unsigned short height, bool limit_framerate)
-	: game(game), title(title), width(width), height(height), framerate_limited(limit_framerate) {
+	Window::Window(Game& game, const char* title, unsigned short width, unsigned short height, bool limit_framerate, WindowBackend backend)
+	: game(game), glfw_window(nullptr), title(title), width(width), height(height), framerate_limited(limit_framerate),
+	  x(0.0f), y(0.0f), received_events(false), events_polled(false), backend(backend), closed(false), capture(nullptr) {
+		// set before loadAssets so it can
+		// check what the window was made with
+		game.window = this;
+
+		// without a display there's nothing to make,
+		// the game only gets input from replays
+		if (backend == WindowBackend::Null) {
+			game.loadAssets();
+			std::cout << "Headless window, OpenGL is unavailable" << std::endl;
+			return;
+		}
+
 		// errorCallback is able to be called before glfwInit
 		// and glfwInit can fail, so if it does happen, it
 		// would be beneficial to see the error
@@ -60,7 +116,29 @@ namespace kdr {
 			throw error;
 		}
 		
+		// a hidden window is only there for its context
+		// GLFW 3.2 still needs a display for glfwInit, EGL
+		// only makes the context without GLX or WGL
+		if (backend == WindowBackend::Hidden) {
+			glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+			glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+		}
+
 		glfw_window = glfwCreateWindow(width, height, title, NULL, NULL);
+		// fall back to the native context
+		// if the driver doesn't do EGL
+		if (glfw_window == nullptr && backend == WindowBackend::Hidden) {
+			glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_NATIVE_CONTEXT_API);
+			glfw_window = glfwCreateWindow(width, height, title, NULL, NULL);
+		}
+		glfwDefaultWindowHints();
+
+		if (glfw_window == nullptr) {
+			glfwTerminate();
+			std::runtime_error error = std::runtime_error("GLFW failed to create a window\nAborting creation of window");
+			std::cout << error.what() << std::endl;
+			throw error;
+		}
 		glfwHideWindow(glfw_window);
 
 		// glfw is initialized now
@@ -70,13 +148,16 @@ namespace kdr {
 		glfwMakeContextCurrent(glfw_window);
 		//glfwHideWindow(glfw_window);
 		game.loadAssets();
-		glfwShowWindow(glfw_window);
+		if (backend == WindowBackend::Glfw)
+			glfwShowWindow(glfw_window);
 
 		glfwSetWindowUserPointer(glfw_window, this);
 		glfwSetFramebufferSizeCallback(glfw_window, windowResize);
 		glfwSetKeyCallback(glfw_window, keyCallback);
 		glfwSetMouseButtonCallback(glfw_window, mouseButtonCallback);
 		glfwSetCursorPosCallback(glfw_window, cursorPositionCallback);
+		glfwSetCharCallback(glfw_window, charCallback);
+		glfwSetScrollCallback(glfw_window, scrollCallback);
 
 		// enable vsync if framerate_limited is true
 		// don't limit if false
@@ -107,35 +188,116 @@ namespace kdr {
 	}
 
 	Window::~Window() {
-		delete glfw_window;
+		// the capture's buffers need the context
+		delete capture;
+		// glfw owns its windows, so they can't be deleted
+		if (glfw_window != nullptr)
+			glfwDestroyWindow(glfw_window);
 		return;
 	}
 
 	void Window::update() {
-		KDR_UpdateKeys();
+		// only replays set input without a window
+		if (backend == WindowBackend::Null) {
+			KDR_UpdateKeys();
+			return;
+		}
+
 		GLenum errors = glGetError();
 		// if there are any errors, print them
 		// glGetError clears the first error found
 		// from the "list" of errors
 		if (errors != GL_NO_ERROR)
 			std::cout << "OpenGL error " << errors << std::endl;
+
+		// waitEvents already moved the keys along
+		// and processed this frame's events
+		if (events_polled) {
+			events_polled = false;
+			return;
+		}
+		KDR_UpdateKeys();
 		glfwPollEvents();
 		return;
 	}
 
+	void Window::waitEvents(double timeout) {
+		KDR_UpdateKeys();
+		// nothing can arrive without a window
+		if (backend != WindowBackend::Null)
+			glfwWaitEventsTimeout(timeout);
+		events_polled = true;
+		return;
+	}
+
+	bool Window::consumeEvents() {
+		const bool events = received_events;
+		received_events = false;
+		return events;
+	}
+
 	void Window::draw() {
-		glfwSwapBuffers(glfw_window);
+		// the back buffer is only defined until it's swapped
+		if (capture != nullptr)
+			capture->readback(width, height);
+		if (glfw_window != nullptr)
+			glfwSwapBuffers(glfw_window);
+		// swapping is the end of a frame
+		KDR_ProfilerNextFrame();
 		return;
 	}
 
 	void Window::clear() {
 		// clears the OpenGL color
 		// and depth buffers
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		if (backend != WindowBackend::Null)
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		return;
 	}
 
+	bool Window::makeCapture() {
+		if (backend == WindowBackend::Null) {
+			std::cout << "Unable to capture frames without OpenGL" << std::endl;
+			return false;
+		}
+		if (capture == nullptr)
+			capture = new FrameCapture();
+		return true;
+	}
+
+	bool Window::captureFrame(const char* file_path, CaptureFormat format) {
+		if (!makeCapture())
+			return false;
+		capture->request(file_path, format);
+		return true;
+	}
+
+	bool Window::startFrameDump(const char* file_path, CaptureFormat format) {
+		if (!makeCapture())
+			return false;
+		return capture->startDump(file_path, format);
+	}
+
+	void Window::stopFrameDump() {
+		if (capture != nullptr)
+			capture->stopDump();
+		return;
+	}
+
+	unsigned int Window::getDroppedCaptures() const {
+		return capture ? capture->getDropped() : 0;
+	}
+
 	bool Window::isRunning() const {
+		if (glfw_window == nullptr)
+			return !closed;
 		return !glfwWindowShouldClose(glfw_window);
 	}
+
+	void Window::close() {
+		closed = true;
+		if (glfw_window != nullptr)
+			glfwSetWindowShouldClose(glfw_window, GLFW_TRUE);
+		return;
+	}
 }
\ No newline at end of file
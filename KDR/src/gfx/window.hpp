@@ -3,9 +3,35 @@
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "captureformat.hpp"
 
 namespace kdr {
 	class Game;
+	class FrameCapture;
+
+	/*
+	 What a Window is made with
+	 */
+	enum class WindowBackend {
+		/*
+		 A visible GLFW window with an OpenGL context
+		 */
+		Glfw   = 0,
+		/*
+		 A GLFW window that's never shown, with an EGL
+		 context when the driver has one
+		 Still needs a display, GLFW 3.2 can't start without one
+		 Draw into a RenderTarget since a hidden window's
+		 pixels may never be drawn
+		 */
+		Hidden = 1,
+		/*
+		 No window and no OpenGL at all
+		 For simulations and replays on machines without a display,
+		 nothing that uses OpenGL can be made
+		 */
+		Null   = 2
+	};
 
 	/*
 	 Window of the game
@@ -21,21 +47,56 @@ namespace kdr {
 		unsigned short height;
 		bool framerate_limited;
 		float x, y;
+		/*
+		 Whether any input or resize arrived
+		 since the last consumeEvents
+		 */
+		bool received_events;
+		/*
+		 Whether waitEvents already processed this
+		 frame's events so update doesn't again
+		 */
+		bool events_polled;
+		/*
+		 What the window was made with
+		 */
+		WindowBackend backend;
+		/*
+		 Set by close for the Null backend
+		 which has no GLFW window to close
+		 */
+		bool closed;
+		/*
+		 Reads frames back for captureFrame,
+		 made the first time it's needed
+		 */
+		FrameCapture* capture;
+
+		/*
+		 Makes capture if it hasn't been
+		 Returns false if there's no OpenGL to capture from
+		 */
+		bool makeCapture();
 
 	public:
 		/*
 		 Creates the window of the game
 		 Does not have ownership over Game
 		 Only calls glewInit once
+		 Sets game.window before calling game.loadAssets,
+		 so loadAssets can check isHeadless
 		 @param title: title of the window
 		 @param width: width of the window in pixels
 		 @param height: height of the window in pixels
 		 @param limit_framerate: whether or not the game's framerate
 		 will be limited by vsync
+		 @param backend: what the window is made with,
+		 Null needs no display or OpenGL
 		 */
-		Window(Game& game, const char* title, unsigned short width, unsigned short height, bool limit_framerate);
+		Window(Game& game, const char* title, unsigned short width, unsigned short height, bool limit_framerate, WindowBackend backend = WindowBackend::Glfw);
 		/*
 		 Deletes the glfw window tied to this class
+		 Waits for captured frames to be written
 		 */
 		~Window();
 
@@ -48,6 +109,20 @@ namespace kdr {
 		*/
 		void update();
 
+		/*
+		 Sleeps until an event arrives or timeout seconds pass
+		 and processes the events like update would
+		 The next update won't poll again so keys pressed
+		 while waiting still show as pressed
+		 */
+		void waitEvents(double timeout);
+
+		/*
+		 Returns whether any input or resize arrived since
+		 the last call, and clears it
+		 */
+		bool consumeEvents();
+
 		/*
 		 Draws all data bound to the window
 		 */
@@ -58,11 +133,58 @@ namespace kdr {
 		 */
 		void clear();
 
+		/*
+		 Saves the frame being drawn once draw is called
+		 The pixels are read back a frame or two later and written
+		 on another thread, so it doesn't slow the game down
+		 Returns false if the window has no OpenGL context
+		 */
+		bool captureFrame(const char* file_path, CaptureFormat format = CaptureFormat::Png);
+
+		/*
+		 Saves every frame until stopFrameDump, IE for replay videos
+		 @param file_path: a single file for raw frames, a pattern
+		 with a single %u or %0Nu for PNGs IE "dump/frame%06u.png"
+		 Returns false if the window has no OpenGL context
+		 or the PNG pattern doesn't have a %u
+		 */
+		bool startFrameDump(const char* file_path, CaptureFormat format = CaptureFormat::Raw);
+
+		/*
+		 Stops saving every frame
+		 */
+		void stopFrameDump();
+
+		/*
+		 Returns how many captured frames were dropped
+		 because they couldn't be written fast enough
+		 */
+		unsigned int getDroppedCaptures() const;
+
 		/*
 		 Returns whether or not the window should close
 		 */
 		bool isRunning() const;
 
+		/*
+		 Makes isRunning return false
+		 */
+		void close();
+
+		/*
+		 Returns what the window was made with
+		 */
+		inline WindowBackend getBackend() const {
+			return backend;
+		}
+
+		/*
+		 Returns true if there's no OpenGL context
+		 */
+		inline bool isHeadless() const {
+			return backend == WindowBackend::Null;
+		}
+
 		inline const int getWidth() const {
 			return width;
 		}
@@ -110,6 +232,19 @@ namespace kdr {
 		 @param window: the glfw window of the window
 		 */
 		friend void cursorPositionCallback(GLFWwindow* window, double x, double y);
+
+		/*
+		 Callback function for glfw typing a character
+		 @param codepoint: the unicode codepoint typed
+		 */
+		friend void charCallback(GLFWwindow* window, unsigned int codepoint);
+
+		/*
+		 Callback function for glfw scrolling
+		 @param x_offset: how far it scrolled sideways
+		 @param y_offset: how far it scrolled up or down
+		 */
+		friend void scrollCallback(GLFWwindow* window, double x_offset, double y_offset);
 	};
 }
 
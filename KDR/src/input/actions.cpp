@@ -0,0 +1,255 @@
+#include "actions.hpp"
+#include "input.hpp"
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+#include <nlohmann/json.hpp>
+
+namespace kdr {
+	/*
+	 A key or button and the keys held with it
+	 Each chord key has a second key that also counts
+	 so "Ctrl" can match either control key
+	 */
+	struct ActionBinding {
+		uint16_t input;
+		bool button;
+		uint8_t chord_count;
+		uint16_t chord[MAX_CHORD_KEYS][2];
+		uint8_t action;
+	};
+
+	/*
+	 A name a binding can use
+	 */
+	struct InputName {
+		const char* name;
+		int key;
+		int alternate;
+		bool button;
+	};
+
+	const InputName input_names[] = {
+		{ "Space", 32, 32, false }, { "Apostrophe", 39, 39, false }, { "Comma", 44, 44, false },
+		{ "Minus", 45, 45, false }, { "Period", 46, 46, false }, { "Slash", 47, 47, false },
+		{ "Semicolon", 59, 59, false }, { "Equal", 61, 61, false }, { "BracketLeft", 91, 91, false },
+		{ "Backslash", 92, 92, false }, { "BracketRight", 93, 93, false }, { "Grave", 96, 96, false },
+		{ "Escape", 256, 256, false }, { "Enter", 257, 257, false }, { "Tab", 258, 258, false },
+		{ "Backspace", 259, 259, false }, { "Insert", 260, 260, false }, { "Delete", 261, 261, false },
+		{ "Right", 262, 262, false }, { "Left", 263, 263, false }, { "Down", 264, 264, false },
+		{ "Up", 265, 265, false }, { "PageUp", 266, 266, false }, { "PageDown", 267, 267, false },
+		{ "Home", 268, 268, false }, { "End", 269, 269, false }, { "CapsLock", 280, 280, false },
+		{ "ScrollLock", 281, 281, false }, { "NumLock", 282, 282, false }, { "PrintScreen", 283, 283, false },
+		{ "Pause", 284, 284, false }, { "KPDec", 330, 330, false }, { "KPDiv", 331, 331, false },
+		{ "KPMult", 332, 332, false }, { "KPSub", 333, 333, false }, { "KPAdd", 334, 334, false },
+		{ "KPEnter", 335, 335, false }, { "KPEqual", 336, 336, false }, { "LeftShift", 340, 340, false },
+		{ "LeftCtrl", 341, 341, false }, { "LeftAlt", 342, 342, false }, { "LeftSuper", 343, 343, false },
+		{ "RightShift", 344, 344, false }, { "RightCtrl", 345, 345, false }, { "RightAlt", 346, 346, false },
+		{ "RightSuper", 347, 347, false }, { "Menu", 348, 348, false },
+		{ "Shift", 340, 344, false }, { "Ctrl", 341, 345, false }, { "Alt", 342, 346, false },
+		{ "Super", 343, 347, false },
+		{ "MouseLeft", 0, 0, true }, { "MouseRight", 1, 1, true }, { "MouseMiddle", 2, 2, true }
+	};
+
+	// the name of every action, indexed by its bit
+	std::vector<std::string> action_names;
+	// every binding of every action
+	std::vector<ActionBinding> action_bindings;
+	// this frame's actions
+	uint64_t actions_down = 0;
+	uint64_t actions_triggered = 0;
+
+	/*
+	 Finds the key or button a name means
+	 Returns false if it isn't one
+	 */
+	static bool findInput(const std::string& name, InputName& input) {
+		input.name = nullptr;
+		input.button = false;
+
+		// letters and numbers are named after themselves
+		if (name.size() == 1 && ((name[0] >= 'A' && name[0] <= 'Z') || (name[0] >= '0' && name[0] <= '9'))) {
+			input.key = input.alternate = name[0];
+			return true;
+		}
+
+		// numbered keys and buttons
+		int number = 0;
+		if (sscanf(name.c_str(), "F%d", &number) == 1 && number >= 1 && number <= 25 && name == "F" + std::to_string(number)) {
+			input.key = input.alternate = (int)Keys::F1 + number - 1;
+			return true;
+		}
+		if (sscanf(name.c_str(), "KP%d", &number) == 1 && number >= 0 && number <= 9 && name.size() == 3) {
+			input.key = input.alternate = (int)Keys::KP0 + number;
+			return true;
+		}
+		if (sscanf(name.c_str(), "Mouse%d", &number) == 1 && number >= 1 && number <= 8 && name.size() == 6) {
+			input.key = input.alternate = number - 1;
+			input.button = true;
+			return true;
+		}
+
+		for (const InputName& known : input_names) {
+			if (name == known.name) {
+				input = known;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/*
+	 Returns the index of an action, making it if it's new
+	 Returns -1 if there's no room for it
+	 */
+	static int findAction(const char* action, bool create) {
+		for (unsigned int i = 0; i < action_names.size(); ++i)
+			if (action_names[i] == action)
+				return (int)i;
+		if (!create || action_names.size() >= MAX_ACTIONS)
+			return -1;
+		action_names.push_back(action);
+		return (int)action_names.size() - 1;
+	}
+
+	bool KDR_BindAction(const char* action, const char* binding) {
+		ActionBinding compiled;
+		memset(&compiled, 0, sizeof(compiled));
+
+		// every part but the last is a key that has to be held
+		std::vector<std::string> parts;
+		const char* part = binding;
+		for (const char* c = binding;; ++c) {
+			if (*c == '+' || *c == '\0') {
+				parts.push_back(std::string(part, c));
+				part = c + 1;
+			}
+			if (*c == '\0')
+				break;
+		}
+
+		if (parts.size() > MAX_CHORD_KEYS + 1) {
+			std::cout << "Invalid action binding, too many keys: " << binding << std::endl;
+			return false;
+		}
+
+		for (unsigned int i = 0; i < parts.size(); ++i) {
+			InputName input;
+			const bool last = i + 1 == parts.size();
+			if (!findInput(parts[i], input) || (input.button && !last)) {
+				std::cout << "Invalid action binding, unknown key " << parts[i] << ": " << binding << std::endl;
+				return false;
+			}
+
+			if (last) {
+				compiled.input = (uint16_t)input.key;
+				compiled.button = input.button;
+			}
+			else {
+				compiled.chord[compiled.chord_count][0] = (uint16_t)input.key;
+				compiled.chord[compiled.chord_count][1] = (uint16_t)input.alternate;
+				++compiled.chord_count;
+			}
+		}
+
+		const int index = findAction(action, true);
+		if (index == -1) {
+			std::cout << "Unable to bind action, there are already " << MAX_ACTIONS << " actions: " << action << std::endl;
+			return false;
+		}
+		compiled.action = (uint8_t)index;
+		action_bindings.push_back(compiled);
+		return true;
+	}
+
+	void KDR_UnbindAction(const char* action) {
+		const int index = findAction(action, false);
+		if (index == -1)
+			return;
+		for (unsigned int i = 0; i < action_bindings.size();) {
+			if (action_bindings[i].action == index) {
+				action_bindings[i] = action_bindings.back();
+				action_bindings.pop_back();
+			}
+			else
+				++i;
+		}
+		return;
+	}
+
+	bool KDR_LoadActions(const char* file_path) {
+		std::ifstream stream(file_path);
+		if (!stream) {
+			std::cout << "Unable to read action file: " << file_path << std::endl;
+			return false;
+		}
+
+		nlohmann::json config;
+		try {
+			stream >> config;
+		}
+		catch (const nlohmann::json::exception& error) {
+			std::cout << "Unable to read action file: " << file_path << '\n' << error.what() << std::endl;
+			return false;
+		}
+
+		if (!config.is_object()) {
+			std::cout << "Unable to read action file, expected an object: " << file_path << std::endl;
+			return false;
+		}
+
+		bool valid = true;
+		for (auto action = config.begin(); action != config.end(); ++action) {
+			KDR_UnbindAction(action.key().c_str());
+			for (const nlohmann::json& binding : action.value()) {
+				if (!binding.is_string()) {
+					valid = false;
+					continue;
+				}
+				valid &= KDR_BindAction(action.key().c_str(), binding.get<std::string>().c_str());
+			}
+		}
+		return valid;
+	}
+
+	uint64_t KDR_ActionMask(const char* action) {
+		const int index = findAction(action, false);
+		return index == -1 ? 0 : (uint64_t)1 << index;
+	}
+
+	void KDR_UpdateActions() {
+		uint64_t down = 0;
+		uint64_t triggered = 0;
+		for (const ActionBinding& binding : action_bindings) {
+			bool held = true;
+			for (unsigned int i = 0; i < binding.chord_count && held; ++i)
+				held = KDR_KeyDown((Keys)binding.chord[i][0]) || KDR_KeyDown((Keys)binding.chord[i][1]);
+			if (!held)
+				continue;
+
+			const uint64_t bit = (uint64_t)1 << binding.action;
+			if (binding.button) {
+				down      |= KDR_ButtonDown((Buttons)binding.input)    ? bit : 0;
+				triggered |= KDR_ButtonPressed((Buttons)binding.input) ? bit : 0;
+			}
+			else {
+				down      |= KDR_KeyDown((Keys)binding.input)    ? bit : 0;
+				triggered |= KDR_KeyPressed((Keys)binding.input) ? bit : 0;
+			}
+		}
+		actions_down = down;
+		actions_triggered = triggered;
+		return;
+	}
+
+	uint64_t KDR_ActionsDown() {
+		return actions_down;
+	}
+
+	uint64_t KDR_ActionsTriggered() {
+		return actions_triggered;
+	}
+}
\ No newline at end of file
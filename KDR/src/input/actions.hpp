@@ -0,0 +1,85 @@
+#ifndef _KDR_ACTIONS_HPP
+#define _KDR_ACTIONS_HPP
+
+#include <stdint.h>
+
+/*
+ Every action is a bit of a 64 bit mask
+ */
+#define MAX_ACTIONS (64)
+
+/*
+ The most keys that have to be held
+ along with a binding's key
+ */
+#define MAX_CHORD_KEYS (3)
+
+namespace kdr {
+	/*
+	 Loads action bindings from a JSON file like
+	 {
+		"move_up": [ "Up", "KP8", "K" ],
+		"save":    [ "Ctrl+S" ],
+		"select":  [ "MouseLeft" ]
+	 }
+	 Keys are named like the Keys enum, numbers are "0" to "9",
+	 mouse buttons are "Mouse1" to "Mouse8" or "MouseLeft",
+	 "MouseRight" and "MouseMiddle", and "Ctrl", "Shift", "Alt"
+	 and "Super" match either side
+	 Replaces the bindings of every action in the file
+	 Returns false if the file couldn't be read or has an invalid binding
+	 */
+	bool KDR_LoadActions(const char* file_path);
+
+	/*
+	 Adds a binding to an action, making the action if it's new
+	 @param binding: a key or button with any keys that have to be
+	 held joined by '+', IE "Ctrl+Shift+S"
+	 Returns false if a name isn't a key or there are too many actions
+	 */
+	bool KDR_BindAction(const char* action, const char* binding);
+
+	/*
+	 Removes every binding of an action
+	 */
+	void KDR_UnbindAction(const char* action);
+
+	/*
+	 Returns the bit of an action to test the masks with
+	 Look it up once and keep it
+	 Returns 0 if there's no action with the name
+	 */
+	uint64_t KDR_ActionMask(const char* action);
+
+	/*
+	 Works out this frame's actions from the keys
+	 Called by KDR_UpdateKeys
+	 */
+	void KDR_UpdateActions();
+
+	/*
+	 Returns every action with a binding held down
+	 */
+	uint64_t KDR_ActionsDown();
+
+	/*
+	 Returns every action with a binding pressed this frame
+	 */
+	uint64_t KDR_ActionsTriggered();
+
+	/*
+	 Returns true if any of the actions in mask are held down
+	 */
+	inline bool KDR_ActionDown(uint64_t mask) {
+		return (KDR_ActionsDown() & mask) != 0;
+	}
+
+	/*
+	 Returns true if any of the actions in mask were pressed this frame
+	 */
+	inline bool KDR_ActionTriggered(uint64_t mask) {
+		return (KDR_ActionsTriggered() & mask) != 0;
+	}
+}
+
+#endif // hi :)
\ No newline at end of file
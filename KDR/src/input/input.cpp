@@ -1,14 +1,26 @@
 #include "input.hpp"
+#include "inputrecorder.hpp"
+#include "actions.hpp"
 #include <string.h>
 #include <assert.h>
+#include <stdint.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 namespace kdr {
+	static_assert(MAX_KEYS % 64 == 0, "MAX_KEYS has to fill whole words");
+	static_assert(MAX_BUTTONS <= 64, "MAX_BUTTONS has to fit in one word");
+
+	/*
+	 One bit per key and button
+	 */
 	struct KeyState {
-		bool keys[MAX_KEYS];
-		bool buttons[MAX_BUTTONS];
+		uint64_t keys[KEY_WORDS];
+		uint64_t buttons;
 		KeyState() {
-			memset(keys, false, MAX_KEYS);
-			memset(buttons, false, MAX_BUTTONS);
+			memset(keys, 0, sizeof(keys));
+			buttons = 0;
 			return;
 		}
 	};
@@ -16,55 +28,165 @@ namespace kdr {
 	// represents keys that do fire repeatedly when held down
 	KeyState current = KeyState();
 	// represents keys that do not fire repeatedly when held down
-	KeyState previous = KeyState();
+	KeyState pressed = KeyState();
+	// represents keys that were let go this frame
+	KeyState released = KeyState();
 	// represents the keys that glfw sets each window update
 	KeyState glfw = KeyState();
+	// where the cursor is in pixels
+	double cursor_x = 0.0, cursor_y = 0.0;
+
+	/*
+	 Returns the bit of index in words
+	 */
+	static inline bool getBit(const uint64_t* words, int index) {
+		return (words[index >> 6] >> (index & 63)) & 1;
+	}
+
+	/*
+	 Sets the bit of index in words to val
+	 */
+	static inline void setBit(uint64_t* words, int index, bool val) {
+		const uint64_t bit = (uint64_t)1 << (index & 63);
+		if (val)
+			words[index >> 6] |= bit;
+		else
+			words[index >> 6] &= ~bit;
+		return;
+	}
+
+	/*
+	 Returns the index of the lowest set bit
+	 word can't be 0
+	 */
+	static inline unsigned int lowestBit(uint64_t word) {
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward64(&index, word);
+		return (unsigned int)index;
+#else
+		return (unsigned int)__builtin_ctzll(word);
+#endif
+	}
 
 	bool KDR_KeyDown(Keys key) {
-		return current.keys[(int)key];
+		return getBit(current.keys, (int)key);
 	}
 
 	bool KDR_KeyPressed(Keys key) {
-		return previous.keys[(int)key];
+		return getBit(pressed.keys, (int)key);
+	}
+
+	bool KDR_KeyReleased(Keys key) {
+		return getBit(released.keys, (int)key);
 	}
 
 	bool KDR_ButtonDown(Buttons button) {
-		return current.buttons[(int)button];
+		return (current.buttons >> (int)button) & 1;
 	}
 
 	bool KDR_ButtonPressed(Buttons button) {
-		return previous.buttons[(int)button];
+		return (pressed.buttons >> (int)button) & 1;
+	}
+
+	bool KDR_ButtonReleased(Buttons button) {
+		return (released.buttons >> (int)button) & 1;
+	}
+
+	unsigned int KDR_ChangedKeys(Keys* keys, unsigned int max_keys) {
+		unsigned int count = 0;
+		for (unsigned int w = 0; w < KEY_WORDS; ++w) {
+			uint64_t changed = pressed.keys[w] | released.keys[w];
+			// take the lowest bit off until the word is empty
+			// so only the keys that changed are visited
+			while (changed != 0 && count < max_keys) {
+				keys[count++] = (Keys)(w * 64 + lowestBit(changed));
+				changed &= changed - 1;
+			}
+		}
+		return count;
+	}
+
+	double KDR_CursorX() {
+		return cursor_x;
+	}
+
+	double KDR_CursorY() {
+		return cursor_y;
 	}
 
 	void KDR_UpdateKeys() {
-		for (unsigned short i = 0; i < MAX_KEYS; ++i)
-			// since previous keys are keys that are only true for one
-			// frame when held down, we need to check if the current key
-			// isn't down anymore, but we also need to check if the keys
-			// are being pressed down at all, which is where glfw keys comes in
-			previous.keys[i] = glfw.keys[i] && !current.keys[i];
-		// since current is a POD, we can memcpy without concern
-		// and it's faster than a for loop
-		memcpy(current.keys, glfw.keys, MAX_KEYS);
-		for (unsigned short i = 0; i < MAX_BUTTONS; ++i)
-			// since previous buttons are buttons that are only true for one
-			// frame when held down, we need to check if the current button
-			// isn't down anymore, but we also need to check if the buttons
-			// are being pressed down at all, which is where glfw buttons comes in
-			previous.buttons[i] = glfw.keys[i] && !current.keys[i];
-		// since current is a POD, we can memcpy without concern
-		// and it's faster than a for loop
-		memcpy(current.buttons, glfw.buttons, MAX_BUTTONS);
+		// a replay sets this tick's input here
+		KDR_InputRecorderTick();
+
+		// a key is pressed if glfw has it down but it wasn't
+		// down last frame, and released if it's the other way
+		// around, a whole word of keys at a time
+		for (unsigned int w = 0; w < KEY_WORDS; ++w) {
+			pressed.keys[w]  =  glfw.keys[w] & ~current.keys[w];
+			released.keys[w] = ~glfw.keys[w] &  current.keys[w];
+			current.keys[w]  =  glfw.keys[w];
+		}
+		pressed.buttons  =  glfw.buttons & ~current.buttons;
+		released.buttons = ~glfw.buttons &  current.buttons;
+		current.buttons  =  glfw.buttons;
+
+		// the actions follow the keys
+		KDR_UpdateActions();
+		return;
+	}
+
+	void KDR_ResetInput() {
+		current = KeyState();
+		pressed = KeyState();
+		released = KeyState();
+		glfw = KeyState();
+		cursor_x = 0.0;
+		cursor_y = 0.0;
+		return;
+	}
+
+	void KDR_RecordHeldInput() {
+		for (unsigned int w = 0; w < KEY_WORDS; ++w) {
+			uint64_t held = glfw.keys[w];
+			while (held != 0) {
+				KDR_RecordInput(InputRecordType::Key, (int)(w * 64 + lowestBit(held)), true, 0.0, 0.0);
+				held &= held - 1;
+			}
+		}
+		uint64_t held = glfw.buttons;
+		while (held != 0) {
+			KDR_RecordInput(InputRecordType::Button, (int)lowestBit(held), true, 0.0, 0.0);
+			held &= held - 1;
+		}
+		KDR_RecordInput(InputRecordType::Cursor, 0, false, cursor_x, cursor_y);
 		return;
 	}
 
 	void KDR_SetKey(int key, bool val) {
-		glfw.keys[key] = val;
+		// glfw sends -1 for keys it doesn't know
+		if (key < 0 || key >= MAX_KEYS)
+			return;
+		if (!KDR_RecordInput(InputRecordType::Key, key, val, 0.0, 0.0))
+			return;
+		setBit(glfw.keys, key, val);
 		return;
 	}
 
 	void KDR_SetButton(int button, bool val) {
-		glfw.buttons[button] = val;
+		if (button < 0 || button >= MAX_BUTTONS)
+			return;
+		if (!KDR_RecordInput(InputRecordType::Button, button, val, 0.0, 0.0))
+			return;
+		setBit(&glfw.buttons, button, val);
+		return;
+	}
+
+	void KDR_SetCursor(double x, double y) {
+		if (!KDR_RecordInput(InputRecordType::Cursor, 0, false, x, y))
+			return;
+		cursor_x = x;
+		cursor_y = y;
 		return;
 	}
 }
\ No newline at end of file
@@ -4,6 +4,11 @@
 #define MAX_KEYS	1024
 #define MAX_BUTTONS	32
 
+/*
+ Keys are stored a bit each, 64 to a word
+ */
+#define KEY_WORDS	(MAX_KEYS / 64)
+
 namespace kdr {
 	/*
 	 Keyboard keys
@@ -186,6 +191,11 @@ namespace kdr {
 	 released at least one frame ago
 	 */
 	bool KDR_KeyPressed(Keys key);
+	/*
+	 Returns true if the key was active last
+	 frame and isn't anymore
+	 */
+	bool KDR_KeyReleased(Keys key);
 	/*
 	 Returns true if the button is active
 	 */
@@ -195,6 +205,26 @@ namespace kdr {
 	 released at least one frame ago
 	 */
 	bool KDR_ButtonPressed(Buttons button);
+	/*
+	 Returns true if the button was active last
+	 frame and isn't anymore
+	 */
+	bool KDR_ButtonReleased(Buttons button);
+	/*
+	 Fills keys with every key that was pressed or
+	 released this frame, only looking at words that changed
+	 Returns how many keys were written
+	 @param max_keys: the size of keys
+	 */
+	unsigned int KDR_ChangedKeys(Keys* keys, unsigned int max_keys);
+	/*
+	 Returns the cursor's x position in pixels
+	 */
+	double KDR_CursorX();
+	/*
+	 Returns the cursor's y position in pixels
+	 */
+	double KDR_CursorY();
 	/*
 	 Warning: is only used for window callback functions
 	 Should not be used for game development
@@ -207,9 +237,28 @@ namespace kdr {
 	 Sets a button at the specified index to the value
 	 */
 	void KDR_SetButton(int button, bool val);
+	/*
+	 Warning: is only used for window callback functions
+	 Should not be used for game development
+	 Sets the cursor's position
+	 */
+	void KDR_SetCursor(double x, double y);
+	/*
+	 Warning: is only used by the input recorder
+	 Lets go of every key and button and
+	 moves the cursor back to 0, 0
+	 */
+	void KDR_ResetInput();
+	/*
+	 Warning: is only used by the input recorder
+	 Records every key and button being held
+	 and where the cursor is
+	 */
+	void KDR_RecordHeldInput();
 	/*
 	 Updates the keys and sets their values
 	 according to the window's callback function
+	 Works a word of 64 keys at a time
 	 */
 	void KDR_UpdateKeys();
 }
@@ -0,0 +1,57 @@
+#include "inputqueue.hpp"
+
+namespace kdr {
+	static_assert((INPUT_QUEUE_SIZE & (INPUT_QUEUE_SIZE - 1)) == 0, "INPUT_QUEUE_SIZE has to be a power of 2");
+
+	InputQueue::InputQueue()
+	: head(0), tail(0), dropped(0) {
+		return;
+	}
+
+	bool InputQueue::push(const InputEvent& event) {
+		const unsigned int back = tail.load(std::memory_order_relaxed);
+		// the indices keep counting up and wrap on their
+		// own, so the difference is how many are queued
+		if (back - head.load(std::memory_order_acquire) >= INPUT_QUEUE_SIZE) {
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		events[back & (INPUT_QUEUE_SIZE - 1)] = event;
+		// release so the consumer sees the event
+		// before it sees the new tail
+		tail.store(back + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool InputQueue::pop(InputEvent& event) {
+		const unsigned int front = head.load(std::memory_order_relaxed);
+		if (front == tail.load(std::memory_order_acquire))
+			return false;
+		event = events[front & (INPUT_QUEUE_SIZE - 1)];
+		// release so the producer doesn't reuse the
+		// slot before we're done reading it
+		head.store(front + 1, std::memory_order_release);
+		return true;
+	}
+
+	// the queue every window callback pushes to
+	InputQueue input_queue;
+	// games that never poll only use the input state,
+	// so there's nothing to queue for them
+	std::atomic<bool> input_polled(false);
+
+	void KDR_PushInputEvent(const InputEvent& event) {
+		if (input_polled.load(std::memory_order_relaxed))
+			input_queue.push(event);
+		return;
+	}
+
+	bool KDR_PollInputEvent(InputEvent& event) {
+		input_polled.store(true, std::memory_order_relaxed);
+		return input_queue.pop(event);
+	}
+
+	unsigned int KDR_InputEventsDropped() {
+		return input_queue.getDropped();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+#ifndef _KDR_INPUTQUEUE_HPP
+#define _KDR_INPUTQUEUE_HPP
+
+#include <atomic>
+
+/*
+ How many events the queue holds before new ones
+ are dropped, has to be a power of 2
+ */
+#define INPUT_QUEUE_SIZE (1024)
+
+namespace kdr {
+	/*
+	 What kind of input an InputEvent is
+	 */
+	enum class InputEventType {
+		Key    = 0,
+		Button = 1,
+		Cursor = 2,
+		Char   = 3,
+		Scroll = 4
+	};
+
+	/*
+	 A single input in the order it happened
+	 */
+	struct InputEvent {
+		InputEventType type;
+		/*
+		 The key, the button, or the unicode
+		 codepoint of a Char event
+		 */
+		int code;
+		/*
+		 GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT
+		 for keys and buttons
+		 */
+		int action;
+		/*
+		 The modifier keys held
+		 */
+		int mods;
+		/*
+		 The cursor's position for Cursor events
+		 and the offset for Scroll events
+		 */
+		double x, y;
+		/*
+		 When the event happened in seconds
+		 */
+		double time;
+	};
+
+	/*
+	 A lock-free queue with one thread pushing and one popping
+	 The window's callbacks push on the thread that polls events,
+	 the game pops on the thread that ticks
+	 */
+	class InputQueue {
+	private:
+		InputEvent events[INPUT_QUEUE_SIZE];
+		/*
+		 The next event to pop, only written by the consumer
+		 */
+		std::atomic<unsigned int> head;
+		/*
+		 The next slot to push to, only written by the producer
+		 */
+		std::atomic<unsigned int> tail;
+		/*
+		 Events pushed while the queue was full
+		 */
+		std::atomic<unsigned int> dropped;
+
+	public:
+		InputQueue();
+
+		/*
+		 Adds an event to the back of the queue
+		 Returns false and drops the event if the queue is full
+		 Only call from one thread
+		 */
+		bool push(const InputEvent& event);
+
+		/*
+		 Takes the event at the front of the queue
+		 Returns false if the queue is empty
+		 Only call from one thread
+		 */
+		bool pop(InputEvent& event);
+
+		/*
+		 Returns how many events were dropped
+		 because the queue was full
+		 */
+		inline unsigned int getDropped() const {
+			return dropped.load(std::memory_order_relaxed);
+		}
+	};
+
+	/*
+	 Warning: is only used for window callback functions
+	 Adds an event to KDR's input queue
+	 */
+	void KDR_PushInputEvent(const InputEvent& event);
+
+	/*
+	 Takes the oldest input event that hasn't been handled
+	 Drain it every tick with
+	 while (KDR_PollInputEvent(event)) ...
+	 Events are only queued once this has been called,
+	 games that never poll don't fill the queue
+	 Returns false once there are no events left
+	 */
+	bool KDR_PollInputEvent(InputEvent& event);
+
+	/*
+	 Returns how many events were dropped because
+	 the queue wasn't drained every tick
+	 */
+	unsigned int KDR_InputEventsDropped();
+}
+
+#endif // hi :)
\ No newline at end of file
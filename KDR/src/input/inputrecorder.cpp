@@ -0,0 +1,176 @@
+#include "inputrecorder.hpp"
+#include "input.hpp"
+#include <fstream>
+#include <vector>
+#include <stdint.h>
+#include <string.h>
+
+namespace kdr {
+	/*
+	 A single change as it's stored in the file
+	 Keys and buttons only write the first 8 bytes,
+	 cursors write all 16
+	 */
+	struct InputRecord {
+		uint32_t tick;
+		uint8_t type;
+		uint8_t value;
+		uint16_t code;
+		float x, y;
+	};
+
+	static_assert(sizeof(InputRecord) == 16, "InputRecord has to be packed");
+
+	/*
+	 The size of a record without the cursor
+	 */
+	static const size_t INPUT_RECORD_SHORT = 8;
+
+	// the tick input is being set for
+	unsigned long long input_tick = 0;
+
+	// the file being recorded to
+	std::ofstream recording;
+
+	// the replay's changes in order and the next one to play
+	std::vector<InputRecord> replay;
+	size_t replay_index = 0;
+	unsigned long long replay_ticks = 0;
+	bool replaying = false;
+	// true while the replay sets input so it isn't ignored
+	bool replay_applying = false;
+
+	/*
+	 The size of the header, magic, version and tick count
+	 */
+	static const size_t INPUT_HEADER_SIZE = 12;
+
+	bool KDR_StartRecording(const char* file_path) {
+		KDR_StopRecording();
+		recording.open(file_path, std::ios::binary);
+		if (!recording)
+			return false;
+
+		// the tick count is filled in when recording stops
+		const uint32_t header[3] = { INPUT_RECORDING_MAGIC, INPUT_RECORDING_VERSION, 0 };
+		recording.write((const char*)header, sizeof(header));
+		input_tick = 0;
+		// what's already held has to be pressed
+		// again when the replay starts
+		KDR_RecordHeldInput();
+		return true;
+	}
+
+	void KDR_StopRecording() {
+		if (!recording.is_open())
+			return;
+		// the tick count lets replays know how long the
+		// session was even if it ended quietly
+		const uint32_t ticks = (uint32_t)input_tick;
+		recording.seekp(8, std::ios::beg);
+		recording.write((const char*)&ticks, sizeof(ticks));
+		recording.close();
+		return;
+	}
+
+	bool KDR_StartReplay(const char* file_path) {
+		KDR_StopReplay();
+		std::ifstream stream(file_path, std::ios::binary | std::ios::ate);
+		if (!stream)
+			return false;
+		const std::streamsize size = stream.tellg();
+		stream.seekg(0, std::ios::beg);
+		std::vector<char> data((size_t)size);
+		if (size < (std::streamsize)INPUT_HEADER_SIZE || !stream.read(data.data(), size))
+			return false;
+
+		uint32_t header[3];
+		memcpy(header, data.data(), sizeof(header));
+		if (header[0] != INPUT_RECORDING_MAGIC || header[1] != INPUT_RECORDING_VERSION)
+			return false;
+
+		// everything after the header is records, a half
+		// written record at the end is left out
+		const char* read = data.data() + INPUT_HEADER_SIZE;
+		const char* end = data.data() + size;
+		while (read + INPUT_RECORD_SHORT <= end) {
+			InputRecord record = {};
+			memcpy(&record, read, INPUT_RECORD_SHORT);
+			read += INPUT_RECORD_SHORT;
+			if (record.type == (uint8_t)InputRecordType::Cursor) {
+				if (read + 8 > end)
+					break;
+				memcpy(&record.x, read, 8);
+				read += 8;
+			}
+			replay.push_back(record);
+		}
+
+		// a recording that was never stopped has no tick
+		// count, so it lasts until its last change
+		replay_ticks = header[2];
+		if (!replay.empty() && replay.back().tick + 1ull > replay_ticks)
+			replay_ticks = replay.back().tick + 1ull;
+		replay_index = 0;
+		input_tick = 0;
+		// nothing held before the replay can leak into it
+		KDR_ResetInput();
+		replaying = true;
+		return true;
+	}
+
+	void KDR_StopReplay() {
+		replay.clear();
+		replay_index = 0;
+		replay_ticks = 0;
+		replaying = false;
+		return;
+	}
+
+	bool KDR_IsReplaying() {
+		return replaying;
+	}
+
+	bool KDR_ReplayFinished() {
+		return !replaying || input_tick >= replay_ticks;
+	}
+
+	unsigned long long KDR_ReplayTicks() {
+		return replay_ticks;
+	}
+
+	bool KDR_RecordInput(InputRecordType type, int code, bool value, double x, double y) {
+		// real input would change what the replay does
+		if (replaying && !replay_applying)
+			return false;
+
+		if (recording.is_open()) {
+			InputRecord record;
+			record.tick = (uint32_t)input_tick;
+			record.type = (uint8_t)type;
+			record.value = value;
+			record.code = (uint16_t)code;
+			record.x = (float)x;
+			record.y = (float)y;
+			recording.write((const char*)&record, type == InputRecordType::Cursor ? sizeof(record) : INPUT_RECORD_SHORT);
+		}
+		return true;
+	}
+
+	void KDR_InputRecorderTick() {
+		if (replaying) {
+			replay_applying = true;
+			while (replay_index < replay.size() && replay[replay_index].tick <= input_tick) {
+				const InputRecord& record = replay[replay_index++];
+				switch ((InputRecordType)record.type) {
+				case InputRecordType::Key:    KDR_SetKey(record.code, record.value != 0);    break;
+				case InputRecordType::Button: KDR_SetButton(record.code, record.value != 0); break;
+				case InputRecordType::Cursor: KDR_SetCursor(record.x, record.y);             break;
+				}
+			}
+			replay_applying = false;
+		}
+		++input_tick;
+		return;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef _KDR_INPUTRECORDER_HPP
+#define _KDR_INPUTRECORDER_HPP
+
+/*
+ Marks the start of an input recording file
+ Version 2 keeps the tick count in the header
+ */
+#define INPUT_RECORDING_MAGIC   (0x4952444B) // KDRI
+#define INPUT_RECORDING_VERSION (2)
+
+namespace kdr {
+	/*
+	 What a recorded input changed
+	 */
+	enum class InputRecordType {
+		Key    = 0,
+		Button = 1,
+		Cursor = 2
+	};
+
+	/*
+	 Starts writing every key, button and cursor change
+	 to a file along with the tick it happened on
+	 A tick is every call to KDR_UpdateKeys
+	 Keys and buttons already held are written first
+	 so the replay starts from the same input
+	 Returns false if the file couldn't be opened
+	 */
+	bool KDR_StartRecording(const char* file_path);
+
+	/*
+	 Stops recording, writes the tick count
+	 into the header and closes the file
+	 */
+	void KDR_StopRecording();
+
+	/*
+	 Plays a recording back through KDR_SetKey, KDR_SetButton
+	 and KDR_SetCursor, one tick per KDR_UpdateKeys
+	 Every key and button is let go first and real
+	 input is ignored until the replay stops
+	 A file that was never stopped still plays, it
+	 just ends after its last change
+	 Drive it with GameLoop::runHeadless(game, KDR_ReplayTicks())
+	 to run the session as fast as possible
+	 Returns false if the file couldn't be read
+	 */
+	bool KDR_StartReplay(const char* file_path);
+
+	/*
+	 Stops replaying and lets real input through again
+	 */
+	void KDR_StopReplay();
+
+	/*
+	 Returns true while a replay is playing
+	 */
+	bool KDR_IsReplaying();
+
+	/*
+	 Returns true once every recorded tick has played
+	 */
+	bool KDR_ReplayFinished();
+
+	/*
+	 Returns how many ticks the replay lasts
+	 */
+	unsigned long long KDR_ReplayTicks();
+
+	/*
+	 Warning: is only used by the input functions
+	 Records a change if recording
+	 Returns false if the change should be ignored
+	 since a replay is playing
+	 */
+	bool KDR_RecordInput(InputRecordType type, int code, bool value, double x, double y);
+
+	/*
+	 Warning: is only used by KDR_UpdateKeys
+	 Plays the current tick's changes if replaying
+	 and moves on to the next tick
+	 */
+	void KDR_InputRecorderTick();
+}
+
+#endif // hi :)
\ No newline at end of file
@@ -0,0 +1,304 @@
+#include "pngwriter.hpp"
+#include <array>
+#include <fstream>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace kdr {
+	/*
+	 The deflate length and distance tables
+	 */
+	static const uint16_t LENGTH_BASE[29] = {
+		3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+		35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+	};
+	static const uint8_t LENGTH_EXTRA[29] = {
+		0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+		3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+	};
+	static const uint16_t DISTANCE_BASE[30] = {
+		1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+		257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+	};
+	static const uint8_t DISTANCE_EXTRA[30] = {
+		0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+		7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+	};
+
+	/*
+	 How far back matches are looked for
+	 */
+	static const int WINDOW_SIZE = 32768;
+	static const int HASH_SIZE = 1 << 15;
+	/*
+	 How many earlier matches are tried before giving up
+	 */
+	static const int MAX_CHAIN = 16;
+
+	/*
+	 Writes bits starting at the lowest like deflate wants
+	 */
+	struct BitWriter {
+		std::vector<unsigned char>& out;
+		uint32_t bits;
+		int count;
+
+		BitWriter(std::vector<unsigned char>& out) : out(out), bits(0), count(0) {}
+
+		inline void put(uint32_t value, int length) {
+			bits |= value << count;
+			count += length;
+			while (count >= 8) {
+				out.push_back((unsigned char)bits);
+				bits >>= 8;
+				count -= 8;
+			}
+		}
+
+		/*
+		 Huffman codes are sent highest bit first
+		 */
+		inline void putCode(uint32_t code, int length) {
+			uint32_t reversed = 0;
+			for (int i = 0; i < length; ++i)
+				reversed |= ((code >> i) & 1) << (length - 1 - i);
+			put(reversed, length);
+		}
+
+		inline void finish() {
+			if (count > 0)
+				out.push_back((unsigned char)bits);
+			bits = 0;
+			count = 0;
+		}
+	};
+
+	/*
+	 Writes a literal or length symbol with the fixed codes
+	 */
+	static void putSymbol(BitWriter& writer, int symbol) {
+		if (symbol < 144)
+			writer.putCode(0x30 + symbol, 8);
+		else if (symbol < 256)
+			writer.putCode(0x190 + symbol - 144, 9);
+		else if (symbol < 280)
+			writer.putCode(symbol - 256, 7);
+		else
+			writer.putCode(0xC0 + symbol - 280, 8);
+		return;
+	}
+
+	static void putMatch(BitWriter& writer, int length, int distance) {
+		int code = 28;
+		while (LENGTH_BASE[code] > length)
+			--code;
+		putSymbol(writer, 257 + code);
+		writer.put(length - LENGTH_BASE[code], LENGTH_EXTRA[code]);
+
+		code = 29;
+		while (DISTANCE_BASE[code] > distance)
+			--code;
+		writer.putCode(code, 5);
+		writer.put(distance - DISTANCE_BASE[code], DISTANCE_EXTRA[code]);
+		return;
+	}
+
+	static inline uint32_t hash3(const unsigned char* data) {
+		return ((data[0] << 10) ^ (data[1] << 5) ^ data[2]) & (HASH_SIZE - 1);
+	}
+
+	/*
+	 Compresses data into a zlib stream with a single
+	 fixed huffman block
+	 */
+	static void deflate(std::vector<unsigned char>& out, const unsigned char* data, size_t size) {
+		// no preset dictionary, 32k window
+		out.push_back(0x78);
+		out.push_back(0x01);
+
+		BitWriter writer(out);
+		// the only block, fixed codes
+		writer.put(1, 1);
+		writer.put(1, 2);
+
+		std::vector<int32_t> head(HASH_SIZE, -1);
+		std::vector<int32_t> prev(WINDOW_SIZE, -1);
+		size_t i = 0;
+		while (i < size) {
+			int best_length = 0;
+			int best_distance = 0;
+			if (i + 3 <= size) {
+				const uint32_t hash = hash3(data + i);
+				const int max_length = (int)(size - i < 258 ? size - i : 258);
+				int32_t candidate = head[hash];
+				for (int chain = 0; chain < MAX_CHAIN && candidate >= 0 && i - candidate <= WINDOW_SIZE; ++chain) {
+					int length = 0;
+					while (length < max_length && data[candidate + length] == data[i + length])
+						++length;
+					if (length > best_length) {
+						best_length = length;
+						best_distance = (int)(i - candidate);
+						if (length == max_length)
+							break;
+					}
+					candidate = prev[candidate & (WINDOW_SIZE - 1)];
+				}
+				prev[i & (WINDOW_SIZE - 1)] = head[hash];
+				head[hash] = (int32_t)i;
+			}
+
+			if (best_length >= 3) {
+				putMatch(writer, best_length, best_distance);
+				// the skipped bytes can still start matches
+				const size_t end = i + best_length;
+				for (++i; i < end; ++i) {
+					if (i + 3 > size)
+						continue;
+					const uint32_t hash = hash3(data + i);
+					prev[i & (WINDOW_SIZE - 1)] = head[hash];
+					head[hash] = (int32_t)i;
+				}
+			}
+			else {
+				putSymbol(writer, data[i]);
+				++i;
+			}
+		}
+		putSymbol(writer, 256);
+		writer.finish();
+
+		uint32_t a = 1, b = 0;
+		for (size_t j = 0; j < size;) {
+			// 5552 bytes is the most before the sums can overflow
+			const size_t end = j + 5552 < size ? j + 5552 : size;
+			for (; j < end; ++j) {
+				a += data[j];
+				b += a;
+			}
+			a %= 65521;
+			b %= 65521;
+		}
+		const uint32_t adler = (b << 16) | a;
+		out.push_back((unsigned char)(adler >> 24));
+		out.push_back((unsigned char)(adler >> 16));
+		out.push_back((unsigned char)(adler >> 8));
+		out.push_back((unsigned char)adler);
+		return;
+	}
+
+	static uint32_t crc32(const unsigned char* data, size_t size) {
+		// PNGs are written from the capture worker and the main
+		// thread at once, statics are only initialized once
+		static const std::array<uint32_t, 256> table = [] {
+			std::array<uint32_t, 256> entries;
+			for (uint32_t n = 0; n < 256; ++n) {
+				uint32_t c = n;
+				for (int k = 0; k < 8; ++k)
+					c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+				entries[n] = c;
+			}
+			return entries;
+		}();
+		uint32_t crc = 0xFFFFFFFFu;
+		for (size_t i = 0; i < size; ++i)
+			crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+		return crc ^ 0xFFFFFFFFu;
+	}
+
+	static void putBig(std::vector<unsigned char>& out, uint32_t value) {
+		out.push_back((unsigned char)(value >> 24));
+		out.push_back((unsigned char)(value >> 16));
+		out.push_back((unsigned char)(value >> 8));
+		out.push_back((unsigned char)value);
+		return;
+	}
+
+	/*
+	 Adds a chunk around data that's already at the end of out
+	 */
+	static void closeChunk(std::vector<unsigned char>& out, size_t chunk_start) {
+		// the type is included in the crc, the length isn't
+		const size_t length = out.size() - chunk_start - 8;
+		const uint32_t crc = crc32(out.data() + chunk_start + 4, length + 4);
+		out[chunk_start + 0] = (unsigned char)(length >> 24);
+		out[chunk_start + 1] = (unsigned char)(length >> 16);
+		out[chunk_start + 2] = (unsigned char)(length >> 8);
+		out[chunk_start + 3] = (unsigned char)length;
+		putBig(out, crc);
+		return;
+	}
+
+	static size_t openChunk(std::vector<unsigned char>& out, const char* type) {
+		const size_t start = out.size();
+		putBig(out, 0);
+		out.insert(out.end(), type, type + 4);
+		return start;
+	}
+
+	void KDR_EncodePNG(std::vector<unsigned char>& out, const unsigned char* rgba, int width, int height, int stride, bool flip) {
+		if (stride == 0)
+			stride = width * 4;
+		const size_t row_size = (size_t)width * 4;
+
+		// every row gets whichever of none, sub or up
+		// leaves the smallest numbers
+		std::vector<unsigned char> filtered((row_size + 1) * height);
+		std::vector<unsigned char> candidates[3];
+		for (std::vector<unsigned char>& candidate : candidates)
+			candidate.resize(row_size);
+		const unsigned char* above = nullptr;
+		for (int y = 0; y < height; ++y) {
+			const unsigned char* row = rgba + (size_t)(flip ? height - 1 - y : y) * stride;
+			unsigned long long scores[3] = { 0, 0, 0 };
+			for (size_t x = 0; x < row_size; ++x) {
+				const unsigned char left = x >= 4 ? row[x - 4] : 0;
+				const unsigned char up = above ? above[x] : 0;
+				candidates[0][x] = row[x];
+				candidates[1][x] = row[x] - left;
+				candidates[2][x] = row[x] - up;
+				for (int f = 0; f < 3; ++f)
+					scores[f] += candidates[f][x] < 128 ? candidates[f][x] : 256 - candidates[f][x];
+			}
+			int filter = 0;
+			for (int f = 1; f < 3; ++f)
+				if (scores[f] < scores[filter])
+					filter = f;
+
+			unsigned char* write = filtered.data() + (row_size + 1) * y;
+			write[0] = (unsigned char)filter;
+			memcpy(write + 1, candidates[filter].data(), row_size);
+			above = row;
+		}
+
+		out.clear();
+		const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		out.insert(out.end(), signature, signature + 8);
+
+		size_t chunk = openChunk(out, "IHDR");
+		putBig(out, (uint32_t)width);
+		putBig(out, (uint32_t)height);
+		// 8 bits a channel, RGBA, no interlacing
+		const unsigned char header[5] = { 8, 6, 0, 0, 0 };
+		out.insert(out.end(), header, header + 5);
+		closeChunk(out, chunk);
+
+		chunk = openChunk(out, "IDAT");
+		deflate(out, filtered.data(), filtered.size());
+		closeChunk(out, chunk);
+
+		chunk = openChunk(out, "IEND");
+		closeChunk(out, chunk);
+		return;
+	}
+
+	bool KDR_WritePNG(const char* file_path, const unsigned char* rgba, int width, int height, int stride, bool flip) {
+		std::vector<unsigned char> png;
+		KDR_EncodePNG(png, rgba, width, height, stride, flip);
+		std::ofstream stream(file_path, std::ios::binary);
+		if (!stream)
+			return false;
+		stream.write((const char*)png.data(), png.size());
+		return (bool)stream;
+	}
+}
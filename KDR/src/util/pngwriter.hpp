@@ -0,0 +1,26 @@
+#ifndef _KDR_PNGWRITER_HPP
+#define _KDR_PNGWRITER_HPP
+
+#include <vector>
+
+namespace kdr {
+	/*
+	 Encodes RGBA pixels as a PNG
+	 The rows are filtered and compressed with fixed
+	 huffman codes, small enough for screenshots and
+	 fast enough to run every frame on a worker thread
+	 @param out: replaced with the PNG's bytes
+	 @param stride: bytes from one row to the next, 0 for width * 4
+	 @param flip: true if the first row is the bottom of the
+	 image, like OpenGL gives them
+	 */
+	void KDR_EncodePNG(std::vector<unsigned char>& out, const unsigned char* rgba, int width, int height, int stride = 0, bool flip = false);
+
+	/*
+	 Encodes RGBA pixels as a PNG and writes them to a file
+	 Returns false if the file couldn't be written
+	 */
+	bool KDR_WritePNG(const char* file_path, const unsigned char* rgba, int width, int height, int stride = 0, bool flip = false);
+}
+
+#endif // hi :)
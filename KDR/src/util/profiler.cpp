@@ -0,0 +1,275 @@
+#include "profiler.hpp"
+#include <GL/glew.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string.h>
+#include <nlohmann/json.hpp>
+#include "../gfx/renderers/renderer.hpp"
+
+namespace kdr {
+	/*
+	 A GPU zone waiting on OpenGL to finish its query
+	 */
+	struct PendingGpuZone {
+		GLuint query;
+		const char* name;
+		unsigned long long frame;
+		double start;
+		unsigned int depth;
+	};
+
+	const char* counter_names[(int)ProfileCounter::LENGTH] = {
+		"draw calls",
+		"vertices",
+		"texture binds",
+		"flushes"
+	};
+
+	const std::chrono::steady_clock::time_point profiler_origin = std::chrono::steady_clock::now();
+
+	// the history of frames, used as a ring
+	ProfileFrame profile_frames[KDR_PROFILER_FRAMES];
+	// the number of the frame being recorded
+	unsigned long long profile_frame = 0;
+	// how many CPU zones are currently open
+	unsigned int profile_depth = 0;
+
+	// timer queries that aren't being used
+	std::vector<GLuint> free_queries;
+	// timer queries waiting on results
+	std::vector<PendingGpuZone> pending_queries;
+	// OpenGL only allows one GL_TIME_ELAPSED query at a time
+	bool gpu_zone_open = false;
+
+	/*
+	 Returns the frame being recorded
+	 */
+	static inline ProfileFrame& currentFrame() {
+		return profile_frames[profile_frame % KDR_PROFILER_FRAMES];
+	}
+
+	double KDR_ProfilerTime() {
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - profiler_origin).count();
+	}
+
+	void KDR_ProfilerRecord(const char* name, double start) {
+		ProfileZoneRecord record;
+		record.name = name;
+		record.depth = profile_depth;
+		record.start = start;
+		record.duration = KDR_ProfilerTime() - start;
+		record.gpu = false;
+		currentFrame().zones.push_back(record);
+		return;
+	}
+
+	void KDR_ProfilerCount(ProfileCounter counter, unsigned int amount) {
+		currentFrame().counters[(int)counter] += amount;
+		return;
+	}
+
+	ProfileZone::ProfileZone(const char* name)
+	: name(name), start(KDR_ProfilerTime()) {
+		++profile_depth;
+		return;
+	}
+
+	ProfileZone::~ProfileZone() {
+		--profile_depth;
+		KDR_ProfilerRecord(name, start);
+		return;
+	}
+
+	GpuProfileZone::GpuProfileZone(const char* name)
+	: query(NULL) {
+		// if another GPU zone is open or every query is
+		// still waiting on results, skip timing this one
+		if (gpu_zone_open || pending_queries.size() >= KDR_PROFILER_GPU_QUERIES)
+			return;
+
+		if (free_queries.empty()) {
+			GLuint new_query;
+			glGenQueries(1, &new_query);
+			free_queries.push_back(new_query);
+		}
+		query = free_queries.back();
+		free_queries.pop_back();
+
+		PendingGpuZone pending;
+		pending.query = query;
+		pending.name = name;
+		pending.frame = profile_frame;
+		pending.start = KDR_ProfilerTime();
+		pending.depth = profile_depth;
+		pending_queries.push_back(pending);
+
+		gpu_zone_open = true;
+		glBeginQuery(GL_TIME_ELAPSED, query);
+		return;
+	}
+
+	GpuProfileZone::~GpuProfileZone() {
+		if (query == NULL)
+			return;
+		glEndQuery(GL_TIME_ELAPSED);
+		gpu_zone_open = false;
+		return;
+	}
+
+	/*
+	 Moves every GPU timing that's ready into the frame it came from
+	 Never waits on OpenGL, queries that aren't ready are checked
+	 again next frame
+	 */
+	static void collectGpuZones() {
+		for (unsigned int i = 0; i < pending_queries.size();) {
+			PendingGpuZone& pending = pending_queries[i];
+			GLint available = GL_FALSE;
+			glGetQueryObjectiv(pending.query, GL_QUERY_RESULT_AVAILABLE, &available);
+			if (!available) {
+				++i;
+				continue;
+			}
+
+			GLuint64 nanoseconds = 0;
+			glGetQueryObjectui64v(pending.query, GL_QUERY_RESULT, &nanoseconds);
+
+			// only keep the result if its frame
+			// hasn't been overwritten yet
+			if (profile_frame - pending.frame < KDR_PROFILER_FRAMES) {
+				ProfileZoneRecord record;
+				record.name = pending.name;
+				record.depth = pending.depth;
+				record.start = pending.start;
+				record.duration = nanoseconds / 1000000.0;
+				record.gpu = true;
+				profile_frames[pending.frame % KDR_PROFILER_FRAMES].zones.push_back(record);
+			}
+
+			free_queries.push_back(pending.query);
+			// the order doesn't matter so swap the
+			// back in instead of shifting everything
+			pending = pending_queries.back();
+			pending_queries.pop_back();
+		}
+		return;
+	}
+
+	void KDR_ProfilerNextFrame() {
+		const double now = KDR_ProfilerTime();
+		ProfileFrame& finished = currentFrame();
+		finished.number = profile_frame;
+		finished.duration = now - finished.start;
+
+		collectGpuZones();
+
+		++profile_frame;
+		// reuse the oldest frame, clear keeps
+		// the zone vector's memory around
+		ProfileFrame& next = currentFrame();
+		next.number = profile_frame;
+		next.start = now;
+		next.duration = 0.0;
+		next.zones.clear();
+		memset(next.counters, 0, sizeof(next.counters));
+		return;
+	}
+
+	const ProfileFrame& KDR_GetProfileFrame(unsigned int frames_ago) {
+		if (frames_ago >= KDR_PROFILER_FRAMES)
+			frames_ago = KDR_PROFILER_FRAMES - 1;
+		if (frames_ago > profile_frame)
+			frames_ago = (unsigned int)profile_frame;
+		return profile_frames[(profile_frame - frames_ago) % KDR_PROFILER_FRAMES];
+	}
+
+	void KDR_DrawProfiler(Renderer& renderer, const Font& font, const vec3& position, const unsigned int color) {
+		const ProfileFrame& frame = KDR_GetProfileFrame(1);
+		const float line_height = font.getSize() + 2.0f;
+		vec3 line = position;
+		char text[128];
+
+		// y goes up, so each line is drawn below the last
+		snprintf(text, sizeof(text), "frame %llu: %.2f ms", frame.number, frame.duration);
+		renderer.drawString(text, font, line, color);
+		line.y -= line_height;
+
+		// zones are recorded when they end, which puts children
+		// before their parents, so list them by when they started
+		// the vector is kept so drawing doesn't allocate every frame
+		static std::vector<const ProfileZoneRecord*> sorted;
+		sorted.clear();
+		for (const ProfileZoneRecord& zone : frame.zones)
+			sorted.push_back(&zone);
+		std::stable_sort(sorted.begin(), sorted.end(), [](const ProfileZoneRecord* left, const ProfileZoneRecord* right) {
+			return left->start < right->start || (left->start == right->start && left->depth < right->depth);
+		});
+
+		for (const ProfileZoneRecord* zone : sorted) {
+			snprintf(text, sizeof(text), "%*s%s%s: %.3f ms", zone->depth * 2, "", zone->name, zone->gpu ? " (gpu)" : "", zone->duration);
+			renderer.drawString(text, font, line, color);
+			line.y -= line_height;
+		}
+
+		for (int i = 0; i < (int)ProfileCounter::LENGTH; ++i) {
+			snprintf(text, sizeof(text), "%s: %u", counter_names[i], frame.counters[i]);
+			renderer.drawString(text, font, line, color);
+			line.y -= line_height;
+		}
+		return;
+	}
+
+	bool KDR_ExportProfilerTrace(const char* file_path) {
+		using nlohmann::json;
+		json events = json::array();
+
+		// start at the oldest frame so the events are in order
+		const unsigned long long frame_count = profile_frame < KDR_PROFILER_FRAMES ? profile_frame : KDR_PROFILER_FRAMES - 1;
+		for (unsigned long long i = profile_frame - frame_count; i < profile_frame; ++i) {
+			const ProfileFrame& frame = profile_frames[i % KDR_PROFILER_FRAMES];
+
+			// chrome traces are in microseconds
+			events.push_back({
+				{ "name", "frame" }, { "cat", "frame" }, { "ph", "X" },
+				{ "ts", frame.start * 1000.0 }, { "dur", frame.duration * 1000.0 },
+				{ "pid", 0 }, { "tid", 0 }
+			});
+
+			// GPU zones go on their own track since their start
+			// is only when the CPU issued them
+			for (const ProfileZoneRecord& zone : frame.zones) {
+				events.push_back({
+					{ "name", zone.name }, { "cat", zone.gpu ? "gpu" : "cpu" }, { "ph", "X" },
+					{ "ts", zone.start * 1000.0 }, { "dur", zone.duration * 1000.0 },
+					{ "pid", 0 }, { "tid", zone.gpu ? 1 : 0 }
+				});
+			}
+
+			json counters = json::object();
+			for (int c = 0; c < (int)ProfileCounter::LENGTH; ++c)
+				counters[counter_names[c]] = frame.counters[c];
+			events.push_back({
+				{ "name", "counters" }, { "ph", "C" }, { "ts", frame.start * 1000.0 },
+				{ "pid", 0 }, { "args", counters }
+			});
+		}
+
+		std::ofstream stream(file_path);
+		if (!stream)
+			return false;
+		stream << json{ { "traceEvents", events }, { "displayTimeUnit", "ms" } };
+		return stream.good();
+	}
+
+	void KDR_CleanProfiler() {
+		for (GLuint query : free_queries)
+			glDeleteQueries(1, &query);
+		for (const PendingGpuZone& pending : pending_queries)
+			glDeleteQueries(1, &pending.query);
+		free_queries.clear();
+		pending_queries.clear();
+		return;
+	}
+}
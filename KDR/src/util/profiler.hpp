@@ -0,0 +1,189 @@
+#ifndef _KDR_PROFILER_HPP
+#define _KDR_PROFILER_HPP
+
+#include <vector>
+
+/*
+ The amount of frames the profiler
+ keeps before overwriting the oldest
+ */
+#define KDR_PROFILER_FRAMES (120)
+
+/*
+ The amount of GPU timer queries that can
+ be waiting on results at once
+ */
+#define KDR_PROFILER_GPU_QUERIES (64)
+
+#define KDR_PROFILE_CONCAT_INNER(a, b) a##b
+#define KDR_PROFILE_CONCAT(a, b) KDR_PROFILE_CONCAT_INNER(a, b)
+
+// define KDR_NO_PROFILER to compile every
+// profiler macro down to nothing
+#ifndef KDR_NO_PROFILER
+/*
+ Times the rest of the current scope on the CPU
+ */
+#define KDR_PROFILE_ZONE(name) ::kdr::ProfileZone KDR_PROFILE_CONCAT(kdr_profile_zone_, __LINE__)(name)
+/*
+ Times the rest of the current scope on the GPU
+ Only one GPU zone can be open at a time
+ */
+#define KDR_PROFILE_GPU_ZONE(name) ::kdr::GpuProfileZone KDR_PROFILE_CONCAT(kdr_profile_gpu_zone_, __LINE__)(name)
+/*
+ Adds amount to one of the frame's counters
+ */
+#define KDR_PROFILE_COUNT(counter, amount) ::kdr::KDR_ProfilerCount(counter, amount)
+#else
+#define KDR_PROFILE_ZONE(name)
+#define KDR_PROFILE_GPU_ZONE(name)
+#define KDR_PROFILE_COUNT(counter, amount)
+#endif
+
+namespace kdr {
+	class Renderer;
+	class Font;
+	struct vec3;
+
+	/*
+	 Things the profiler counts every frame
+	 */
+	enum class ProfileCounter {
+		DrawCalls    = 0,
+		Vertices     = 1,
+		TextureBinds = 2,
+		Flushes      = 3,
+		LENGTH       = 4
+	};
+
+	/*
+	 A single timed zone of a frame
+	 */
+	struct ProfileZoneRecord {
+		/*
+		 The name the zone was opened with
+		 Has to outlive the profiler, so string literals are expected
+		 */
+		const char* name;
+		/*
+		 How many zones were open around this one
+		 */
+		unsigned int depth;
+		/*
+		 When the zone started in milliseconds
+		 since the profiler started
+		 */
+		double start;
+		/*
+		 How long the zone took in milliseconds
+		 */
+		double duration;
+		/*
+		 Whether the zone was timed on the GPU
+		 */
+		bool gpu;
+	};
+
+	/*
+	 Everything the profiler recorded in one frame
+	 */
+	struct ProfileFrame {
+		/*
+		 The frame's number since the profiler started
+		 */
+		unsigned long long number;
+		/*
+		 When the frame started in milliseconds
+		 since the profiler started
+		 */
+		double start;
+		/*
+		 How long the frame took in milliseconds
+		 */
+		double duration;
+		/*
+		 Every zone that ended in the frame
+		 */
+		std::vector<ProfileZoneRecord> zones;
+		/*
+		 The frame's counters indexed by ProfileCounter
+		 */
+		unsigned int counters[(int)ProfileCounter::LENGTH];
+	};
+
+	/*
+	 Times the scope it lives in on the CPU
+	 Use KDR_PROFILE_ZONE rather than making one directly
+	 */
+	class ProfileZone {
+	private:
+		const char* name;
+		double start;
+
+	public:
+		ProfileZone(const char* name);
+		~ProfileZone();
+	};
+
+	/*
+	 Times the scope it lives in on the GPU with a timer query
+	 The result shows up in the frame a few frames later
+	 once OpenGL has it ready
+	 Use KDR_PROFILE_GPU_ZONE rather than making one directly
+	 */
+	class GpuProfileZone {
+	private:
+		unsigned int query;
+
+	public:
+		GpuProfileZone(const char* name);
+		~GpuProfileZone();
+	};
+
+	/*
+	 Returns the milliseconds since the profiler started
+	 */
+	double KDR_ProfilerTime();
+	/*
+	 Records a zone that started at start and ends now
+	 For zones that are only known to be worth
+	 recording once they're over
+	 */
+	void KDR_ProfilerRecord(const char* name, double start);
+	/*
+	 Adds amount to one of the current frame's counters
+	 */
+	void KDR_ProfilerCount(ProfileCounter counter, unsigned int amount);
+	/*
+	 Ends the current frame and starts the next one
+	 Collects any GPU timings that are ready
+	 Called by Window::draw after swapping buffers
+	 */
+	void KDR_ProfilerNextFrame();
+	/*
+	 Returns a frame from the profiler's history
+	 @param frames_ago: 0 is the frame being recorded,
+	 1 is the last finished frame
+	 */
+	const ProfileFrame& KDR_GetProfileFrame(unsigned int frames_ago = 1);
+	/*
+	 Draws the last finished frame's zones and counters
+	 Has to be called between the renderer's begin and end
+	 Zones are listed in the order they started, parents first
+	 @param position: the top left of the overlay, the
+	 first line is drawn there and the rest go down
+	 */
+	void KDR_DrawProfiler(Renderer& renderer, const Font& font, const vec3& position, const unsigned int color);
+	/*
+	 Writes every frame the profiler holds to a Chrome
+	 trace JSON file (chrome://tracing)
+	 Returns false if the file couldn't be written
+	 */
+	bool KDR_ExportProfilerTrace(const char* file_path);
+	/*
+	 Deletes the profiler's GPU timer queries from OpenGL
+	 */
+	void KDR_CleanProfiler();
+}
+
+#endif // hi :)
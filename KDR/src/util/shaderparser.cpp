@@ -0,0 +1,211 @@
+#include "shaderparser.hpp"
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string.h>
+
+namespace kdr {
+	/*
+	 Where the parser is while it works
+	 through a source and its includes
+	 */
+	struct ShaderParseState {
+		/*
+		 The stage lines are being added to
+		 -1 before the first stage marker
+		 */
+		int stage = -1;
+		/*
+		 Whether the stage still needs its defines added
+		 Stages without a #version get them at the top
+		 once the whole source is read
+		 */
+		bool needs_defines[(int)ShaderStage::LENGTH] = { true, true, true, true };
+	};
+
+	/*
+	 Returns true if text starts with prefix
+	 */
+	static inline bool startsWith(const char* text, const char* text_end, const char* prefix) {
+		const size_t prefix_length = strlen(prefix);
+		return (size_t)(text_end - text) >= prefix_length && memcmp(text, prefix, prefix_length) == 0;
+	}
+
+	/*
+	 Returns the first character of text that isn't a space or tab
+	 */
+	static inline const char* skipSpaces(const char* text, const char* text_end) {
+		while (text < text_end && (*text == ' ' || *text == '\t'))
+			++text;
+		return text;
+	}
+
+	/*
+	 Reads a whole file into contents with a single read
+	 */
+	static bool readFile(const char* file_path, std::string& contents) {
+		std::ifstream stream(file_path, std::ios::binary | std::ios::ate);
+		if (!stream)
+			return false;
+		const std::streamsize size = stream.tellg();
+		stream.seekg(0, std::ios::beg);
+		contents.resize((size_t)size);
+		return size == 0 || (bool)stream.read(&contents[0], size);
+	}
+
+	/*
+	 Returns the folder of a path including the last slash
+	 */
+	static std::string folderOf(const char* file_path) {
+		const char* slash = strrchr(file_path, '/');
+		const char* backslash = strrchr(file_path, '\\');
+		if (backslash > slash)
+			slash = backslash;
+		return slash ? std::string(file_path, slash + 1) : std::string();
+	}
+
+	/*
+	 Adds the options' defines to a stage
+	 */
+	static void appendDefines(std::string& stage, const ShaderParseOptions& options) {
+		for (int i = 0; i < options.define_count; ++i) {
+			stage += "#define ";
+			stage += options.defines[i];
+			stage += '\n';
+		}
+		return;
+	}
+
+	static void parse(const char* source, size_t length, ShaderSources& sources, const ShaderParseOptions& options,
+		const std::string& folder, ShaderParseState& state, int depth) {
+		const char* end = source + length;
+		const char* line = source;
+
+		while (line < end) {
+			// find the end of the line without copying it
+			const char* newline = (const char*)memchr(line, '\n', end - line);
+			const char* line_end = newline ? newline : end;
+			const char* next = newline ? newline + 1 : end;
+			if (line_end > line && line_end[-1] == '\r')
+				--line_end;
+			const char* text = skipSpaces(line, line_end);
+
+			// if the line starts with the shader identifier
+			// then the next word is the name of the stage
+			if (startsWith(text, line_end, options.type_identifier)) {
+				const char* name = skipSpaces(text + strlen(options.type_identifier), line_end);
+				const char* name_end = name;
+				while (name_end < line_end && *name_end != ' ' && *name_end != '\t')
+					++name_end;
+
+				state.stage = -1;
+				for (int i = 0; i < (int)ShaderStage::LENGTH; ++i) {
+					if (strlen(options.stage_names[i]) == (size_t)(name_end - name)
+					 && memcmp(options.stage_names[i], name, name_end - name) == 0) {
+						state.stage = i;
+						break;
+					}
+				}
+
+				if (state.stage == -1) {
+					// it's upon the user to ensure they sent in the correct names
+					// for the stages, so let them know they didn't
+					std::runtime_error error = std::runtime_error("Unable to read shader file:\nInvalid shader name type");
+					std::cout << error.what() << std::endl;
+					throw error;
+				}
+
+				// most stages are about as big as the source plus
+				// its defines, so reserving that saves most of the
+				// reallocations, #includes can still grow it
+				sources.stages[state.stage].reserve(length + 64 * options.define_count);
+			}
+
+			// lines before the first stage have nowhere to go
+			else if (state.stage != -1) {
+				std::string& stage = sources.stages[state.stage];
+
+				if (startsWith(text, line_end, "#include")) {
+					// replace the line with the included file's lines
+					const char* path = (const char*)memchr(text, '"', line_end - text);
+					const char* path_end = path ? (const char*)memchr(path + 1, '"', line_end - path - 1) : nullptr;
+					if (path_end == nullptr || depth >= SHADER_MAX_INCLUDE_DEPTH) {
+						std::runtime_error error = std::runtime_error("Unable to read shader file:\nInvalid or too deeply nested #include");
+						std::cout << error.what() << std::endl;
+						throw error;
+					}
+
+					const std::string include_path = folder + std::string(path + 1, path_end);
+					std::string contents;
+					if (!readFile(include_path.c_str(), contents)) {
+						std::runtime_error error = std::runtime_error("Unable to read shader file:\nCould not open #include");
+						std::cout << error.what() << ' ' << include_path << std::endl;
+						throw error;
+					}
+					parse(contents.data(), contents.size(), sources, options, folderOf(include_path.c_str()), state, depth + 1);
+				}
+
+				else {
+					// #version has to come first in GLSL, so the
+					// defines go right after it, comments and
+					// blank lines can come before it
+					const bool is_version = startsWith(text, line_end, "#version");
+
+					// since compiling shaders is very
+					// dependent on lines, keep the '\n'
+					stage.append(line, line_end);
+					stage += '\n';
+
+					if (state.needs_defines[state.stage] && is_version) {
+						appendDefines(stage, options);
+						state.needs_defines[state.stage] = false;
+					}
+				}
+			}
+
+			line = next;
+		}
+		return;
+	}
+
+	/*
+	 Adds the defines to the top of every stage
+	 that didn't have a #version to put them after
+	 */
+	static void finishDefines(ShaderSources& sources, const ShaderParseOptions& options, const ShaderParseState& state) {
+		if (options.define_count == 0)
+			return;
+		for (int i = 0; i < (int)ShaderStage::LENGTH; ++i) {
+			if (!state.needs_defines[i] || sources.stages[i].empty())
+				continue;
+			std::string defines;
+			appendDefines(defines, options);
+			sources.stages[i].insert(0, defines);
+		}
+		return;
+	}
+
+	void KDR_ParseShader(const char* source, size_t length, ShaderSources& sources, const ShaderParseOptions& options) {
+		ShaderParseState state;
+		parse(source, length, sources, options, options.include_folder, state, 0);
+		finishDefines(sources, options, state);
+		return;
+	}
+
+	void KDR_ParseShaderString(const char* source, ShaderSources& sources, const ShaderParseOptions& options) {
+		KDR_ParseShader(source, strlen(source), sources, options);
+		return;
+	}
+
+	bool KDR_ParseShaderFile(const char* file_path, ShaderSources& sources, const ShaderParseOptions& options) {
+		std::string contents;
+		if (!readFile(file_path, contents))
+			return false;
+
+		// includes are relative to the file
+		ShaderParseState state;
+		parse(contents.data(), contents.size(), sources, options, folderOf(file_path), state, 0);
+		finishDefines(sources, options, state);
+		return true;
+	}
+}
\ No newline at end of file
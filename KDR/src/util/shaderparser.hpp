@@ -0,0 +1,100 @@
+#ifndef _KDR_SHADERPARSER_HPP
+#define _KDR_SHADERPARSER_HPP
+
+#include <string>
+
+/*
+ How deep #include can nest before the
+ parser assumes the includes are circular
+ */
+#define SHADER_MAX_INCLUDE_DEPTH (16)
+
+namespace kdr {
+	/*
+	 The stages a shader source can be split into
+	 */
+	enum class ShaderStage {
+		Vertex   = 0,
+		Fragment = 1,
+		Geometry = 2,
+		Compute  = 3,
+		LENGTH   = 4
+	};
+
+	/*
+	 Tells the parser how the stages are marked
+	 and what to add to each stage
+	 */
+	struct ShaderParseOptions {
+		/*
+		 The token that starts a stage
+		 IE #shader vertex
+		 */
+		const char* type_identifier = "#shader";
+		/*
+		 The name of each stage after the type_identifier
+		 indexed by ShaderStage
+		 */
+		const char* stage_names[(int)ShaderStage::LENGTH] = { "vertex", "fragment", "geometry", "compute" };
+		/*
+		 Defines added to every stage right after its #version line,
+		 or at the top of stages without one
+		 Each one is "NAME" or "NAME VALUE"
+		 */
+		const char* const* defines = nullptr;
+		int define_count = 0;
+		/*
+		 The folder #include "file" is relative to
+		 Set automatically when reading a file
+		 */
+		const char* include_folder = "";
+	};
+
+	/*
+	 The source of each stage of a shader
+	 A stage is empty if the shader doesn't have it
+	 */
+	struct ShaderSources {
+		std::string stages[(int)ShaderStage::LENGTH];
+
+		/*
+		 Returns true if the shader has the stage
+		 */
+		inline bool has(ShaderStage stage) const {
+			return !stages[(int)stage].empty();
+		}
+
+		/*
+		 Returns the source of the stage
+		 */
+		inline const std::string& get(ShaderStage stage) const {
+			return stages[(int)stage];
+		}
+	};
+
+	/*
+	 Splits a shader source into its stages in a single pass
+	 Lines are copied straight from the buffer into the stages
+	 so nothing is allocated per line
+	 Lines before the first stage marker are ignored
+	 #include "file" is replaced with the file's lines
+	 Throws a runtime error if a stage name is invalid
+	 @param source: the shader source, doesn't need a terminator
+	 @param length: the length of source in characters
+	 */
+	void KDR_ParseShader(const char* source, size_t length, ShaderSources& sources, const ShaderParseOptions& options = ShaderParseOptions());
+
+	/*
+	 Splits a shader string into its stages
+	 */
+	void KDR_ParseShaderString(const char* source, ShaderSources& sources, const ShaderParseOptions& options = ShaderParseOptions());
+
+	/*
+	 Reads a shader file with one read and splits it into its stages
+	 #include is relative to the file's folder
+	 Returns false if the file couldn't be read
+	 */
+	bool KDR_ParseShaderFile(const char* file_path, ShaderSources& sources, const ShaderParseOptions& options = ShaderParseOptions());
+}
+
+#endif // hi :)
\ No newline at end of file
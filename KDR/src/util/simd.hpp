@@ -0,0 +1,22 @@
+#ifndef _KDR_SIMD_HPP
+#define _KDR_SIMD_HPP
+
+/*
+ KDR_SSE2 is defined when the compiler can use SSE2
+ Every x64 compiler can, 32 bit MSVC needs /arch:SSE2
+ and GCC or Clang need -msse2
+ KDR_AVX is defined when building with /arch:AVX or -mavx
+ Define KDR_NO_SIMD to use the plain loops instead
+ */
+#ifndef KDR_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define KDR_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(KDR_SSE2) && defined(__AVX__)
+#define KDR_AVX
+#include <immintrin.h>
+#endif
+#endif
+
+#endif // hi :)